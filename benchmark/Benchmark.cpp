@@ -0,0 +1,220 @@
+/*
+ * \file    Benchmark.cpp
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Measures the time of each step of register-interval creation: parsing, CFG creation, splitting, register extraction,
+ *          pass one, each iteration of pass two and the output logs (min/median/p95 over repetitions)
+ *          Note: the steps of a kernel are timed by kernel_basic_blocks and register_interval_passes (a step hook of runStatistics records them).
+ *
+ * Usage: ./Benchmark [--repetitions R] [--registers N] [--generate blocks,blocks,...] [--json file] file1.dot file2.dot ...
+ *        The generated CFGs (random, with the given numbers of basic blocks) are written to output/ and measured after the files.
+ */
+
+//Standard include
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+//File includes
+#include "../src/implementation/Kernel.cpp"
+#include "../src/implementation/DotGenerator.cpp"
+
+using namespace std;
+
+/* \brief The times (ms) of one step over the repetitions*/
+struct phaseTimes
+{
+	string name;
+	vector<double> times;
+
+	double percentile(double p) const{ //nearest rank
+		vector<double> t = times;
+		sort(t.begin(), t.end());
+		int rank = (int)(p / 100.0 * t.size() + 0.999999);
+		return t[min(max(rank, 1), (int)t.size()) - 1];
+	}
+};
+
+/* \brief The results of one input file*/
+struct fileResult
+{
+	string file;
+	size_t bytes;
+	int kernels;
+	int basic_blocks;
+	int intervals;
+	vector<phaseTimes> phases; //in the order of the steps
+};
+
+/* \brief Runs all steps on one file R times*/
+fileResult benchmark_file(const string& file, int REGNUM, int R);
+
+/* \brief Writes the results as JSON*/
+void json_report(const vector<fileResult>& results, int REGNUM, int R, const string& path);
+
+int main(int argc, char **argv)
+{
+	int R = 10;
+	int REGNUM = 16;
+	string json;
+	vector<int> generate;
+	vector<string> files;
+	for (int a = 1; a < argc; a++){
+		string arg = argv[a];
+		if (arg == "--repetitions" && a + 1 < argc)
+			R = max(1, atoi(argv[++a]));
+		else if (arg == "--registers" && a + 1 < argc)
+			REGNUM = atoi(argv[++a]);
+		else if (arg == "--json" && a + 1 < argc)
+			json = argv[++a];
+		else if (arg == "--generate" && a + 1 < argc){
+			stringstream list(argv[++a]);
+			string n;
+			while (getline(list, n, ','))
+				if (atoi(n.c_str()) > 0)
+					generate.push_back(atoi(n.c_str()));
+		}
+		else
+			files.push_back(arg);
+	}
+
+	mkdir("output", 0755); //the logs (and the generated CFGs) are written to output/
+	for (int g = 0; g < generate.size(); g++){
+		string name = "output/synthetic_" + to_string(generate[g]) + ".dot";
+		generatorOptions options;
+		options.blocks = options.seed = generate[g];
+		resultWriter out(name);
+		DotGenerator::generate(options, out);
+		files.push_back(name);
+	}
+	if (files.size() == 0){
+		cerr << "Usage: " << argv[0] << " [--repetitions R] [--registers N] [--generate blocks,blocks,...] [--json file] file1.dot file2.dot ..." << endl;
+		return 1;
+	}
+
+	vector<fileResult> results;
+	cout << left << setw(36) << "file" << setw(14) << "step" << right << setw(12) << "min(ms)" << setw(12) << "median(ms)" << setw(12) << "p95(ms)" << endl;
+	for (int f = 0; f < files.size(); f++){
+		results.push_back(benchmark_file(files[f], REGNUM, R));
+		const fileResult& result = results.back();
+		for (int p = 0; p < result.phases.size(); p++){
+			const phaseTimes& P = result.phases[p];
+			cout << left << setw(36) << (p == 0 ? result.file : "") << setw(14) << P.name << right << fixed << setprecision(3)
+			     << setw(12) << P.percentile(0) << setw(12) << P.percentile(50) << setw(12) << P.percentile(95) << endl;
+		}
+	}
+
+	if (json.size() != 0)
+		json_report(results, REGNUM, R, json);
+	return 0;
+}
+
+fileResult benchmark_file(const string& file, int REGNUM, int R){
+	fileResult result;
+	result.file = file;
+	map<string, int> index; //step -> position in result.phases
+	auto record = [&result, &index](const string& name, int repetition, double time){
+		if (index.find(name) == index.end()){
+			index[name] = result.phases.size();
+			phaseTimes P;
+			P.name = name;
+			result.phases.push_back(P);
+		}
+		vector<double>& times = result.phases[index[name]].times;
+		times.resize(repetition + 1, 0);
+		times[repetition] += time; //the steps of all kernels of the file are added
+	};
+	auto since = [](chrono::steady_clock::time_point& t){
+		auto now = chrono::steady_clock::now();
+		double ms = chrono::duration<double, milli>(now - t).count();
+		t = now;
+		return ms;
+	};
+
+	for (int r = 0; r < R; r++){
+		auto t = chrono::steady_clock::now();
+		auto start = t;
+		inputFile input;
+		input.name = file;
+		parse_input_file(input, "");
+		record("parse", r, since(t));
+		vector<kernel> kernels = find_kernels(&input);
+		result.bytes = input.file.size();
+		result.kernels = kernels.size();
+		result.basic_blocks = result.intervals = 0;
+
+		for (int k = 0; k < kernels.size(); k++){
+			controlFlowGraph graph;
+			runStatistics steps; //the steps of the kernel (cfg, split, registers, pass_one and pass_two_N) are recorded as they end
+			steps.set_step_hook([&record, r](const string& name, double time){ record(name, r, time); });
+			vector<basicBlock*> basic_blocks = kernel_basic_blocks(kernels[k], graph, &steps);
+			result.basic_blocks += basic_blocks.size();
+
+			double pass_time[2] = {0, 0};
+			auto intervals = register_interval_passes(graph, basic_blocks, REGNUM, BUDGET_ALL_REGISTERS, nullptr, false, false, pass_time, nullptr, nullptr, &steps);
+			result.intervals += intervals.size();
+
+			t = chrono::steady_clock::now();
+			basic_blocks_log(basic_blocks, kernels[k]);
+			registerInterval_log(intervals, kernels[k]);
+			record("output", r, since(t));
+		}
+		record("total", r, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+	}
+
+	//a step that did not happen in a repetition (e.g. no kernels) took no time
+	for (int p = 0; p < result.phases.size(); p++)
+		result.phases[p].times.resize(R, 0);
+
+	//the steps are reported in the order they run (the kernels of a file may have different numbers of pass-two iterations)
+	auto order = [](const phaseTimes& P){
+		static const char* steps[] = {"parse", "cfg", "split", "registers", "pass_one"};
+		for (int k = 0; k < 5; k++)
+			if (P.name == steps[k])
+				return k;
+		if (P.name.compare(0, 9, "pass_two_") == 0)
+			return 4 + atoi(P.name.c_str() + 9);
+		return P.name == "output" ? 1 << 20 : 1 << 21;
+	};
+	stable_sort(result.phases.begin(), result.phases.end(), [&order](const phaseTimes& a, const phaseTimes& b){ return order(a) < order(b); });
+	return result;
+}
+
+void json_report(const vector<fileResult>& results, int REGNUM, int R, const string& path){
+	resultWriter out(path);
+	if (!out.is_open()){
+		cerr << "Cannot write " << path << endl;
+		return;
+	}
+	char number[32];
+	out << "{\"registers\":" << REGNUM << ",\"repetitions\":" << R << ",\"files\":[";
+	for (int f = 0; f < results.size(); f++){
+		out << (f == 0 ? "\n" : ",\n") << "{\"file\":";
+		out.json_string(results[f].file);
+		out << ",\"bytes\":" << results[f].bytes << ",\"kernels\":" << results[f].kernels << ",\"basic_blocks\":" << results[f].basic_blocks
+		    << ",\"register_intervals\":" << results[f].intervals << ",\"phases\":{";
+		for (int p = 0; p < results[f].phases.size(); p++){
+			const phaseTimes& P = results[f].phases[p];
+			out << (p == 0 ? "" : ",");
+			out.json_string(P.name);
+			snprintf(number, sizeof(number), "%.6f", P.percentile(0));
+			out << ":{\"min\":" << (const char*)number;
+			snprintf(number, sizeof(number), "%.6f", P.percentile(50));
+			out << ",\"median\":" << (const char*)number;
+			snprintf(number, sizeof(number), "%.6f", P.percentile(95));
+			out << ",\"p95\":" << (const char*)number << "}";
+		}
+		out << "}}";
+	}
+	out << "\n]}\n";
+}
@@ -0,0 +1,69 @@
+/*
+ * \file    GenerateCFG.cpp
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Writes a synthetic CFG in the Graphviz Dot format of nvdisasm (for scaling studies of the parser and both passes)
+ *
+ * Usage: ./GenerateCFG [--blocks N] [--kernels K] [--loop-depth D] [--branch-density p] [--instructions min:max]
+ *                      [--registers R] [--seed S] output.dot
+ */
+
+//Standard include
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+//File includes
+#include "../src/implementation/RegisterSet.cpp"
+#include "../src/implementation/ResultWriter.cpp"
+#include "../src/implementation/DotGenerator.cpp"
+
+using namespace std;
+
+int main(int argc, char **argv)
+{
+	generatorOptions options;
+	string file;
+	for (int a = 1; a < argc; a++){
+		string arg = argv[a];
+		if (a + 1 < argc && arg == "--blocks")
+			options.blocks = atoi(argv[++a]);
+		else if (a + 1 < argc && arg == "--kernels")
+			options.kernels = atoi(argv[++a]);
+		else if (a + 1 < argc && arg == "--loop-depth")
+			options.loop_depth = atoi(argv[++a]);
+		else if (a + 1 < argc && arg == "--branch-density")
+			options.branch_density = atof(argv[++a]);
+		else if (a + 1 < argc && arg == "--instructions"){
+			if (sscanf(argv[++a], "%d:%d", &options.min_instructions, &options.max_instructions) == 1)
+				options.max_instructions = options.min_instructions;
+		}
+		else if (a + 1 < argc && arg == "--registers")
+			options.registers = atoi(argv[++a]);
+		else if (a + 1 < argc && arg == "--seed")
+			options.seed = strtoul(argv[++a], nullptr, 10);
+		else if (arg.size() != 0 && arg[0] != '-' && file.size() == 0)
+			file = arg;
+		else{
+			file.clear();
+			break;
+		}
+	}
+	if (file.size() == 0){
+		cerr << "Usage: " << argv[0] << " [--blocks N] [--kernels K] [--loop-depth D] [--branch-density p] [--instructions min:max]" << endl;
+		cerr << "       " << string(string(argv[0]).size(), ' ') << " [--registers R] [--seed S] output.dot" << endl;
+		return 1;
+	}
+
+	resultWriter out(file);
+	if (!out.is_open()){
+		cerr << "Cannot write " << file << endl;
+		return 1;
+	}
+	long long edges = DotGenerator::generate(options, out);
+	cout << "The number of kernels = " << options.kernels << " #Blocks per kernel = " << options.blocks << " #Edges = " << edges << endl;
+	return 0;
+}
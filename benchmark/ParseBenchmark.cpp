@@ -0,0 +1,68 @@
+/*
+ * \file    ParseBenchmark.cpp
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Measures the throughput of the Graphviz Dot parser
+ *
+ * Usage: ./ParseBenchmark [repetitions] file1.dot file2.dot ...
+ */
+
+//Standard include
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+//File includes
+#include "../src/implementation/DotParser.cpp"
+
+using namespace std;
+
+int main(int argc, char **argv)
+{
+	int first = 1;
+	int repetitions = 20;
+	if (argc > 1 && atoi(argv[1]) > 0){
+		repetitions = atoi(argv[1]);
+		first = 2;
+	}
+
+	cout << left << setw(32) << "file" << right << setw(12) << "bytes" << setw(8) << "nodes" << setw(8) << "edges"
+	     << setw(12) << "best(us)" << setw(12) << "MB/s" << endl;
+
+	size_t total_bytes = 0;
+	double total_seconds = 0;
+	for (int f = first; f < argc; f++){
+		double best = -1;
+		vector<dotNode> nodes;
+		vector<dotEdge> edges;
+		size_t bytes = 0;
+		for (int r = 0; r < repetitions; r++){
+			auto start = chrono::steady_clock::now();
+			mappedFile file;
+			if (!file.open(argv[f])){
+				cerr << "Cannot open the input file: " << argv[f] << endl;
+				break;
+			}
+			DotParser::parse(file, nodes, edges);
+			double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+			if (best < 0 || seconds < best)
+				best = seconds;
+			bytes = file.size();
+		}
+		if (best < 0)
+			continue;
+
+		total_bytes += bytes;
+		total_seconds += best;
+		cout << left << setw(32) << argv[f] << right << setw(12) << bytes << setw(8) << nodes.size() << setw(8) << edges.size()
+		     << setw(12) << fixed << setprecision(1) << best * 1e6 << setw(12) << bytes / best / 1e6 << endl;
+	}
+
+	if (total_seconds > 0)
+		cout << "total: " << total_bytes << " bytes, " << fixed << setprecision(1) << total_bytes / total_seconds / 1e6 << " MB/s" << endl;
+	return 0;
+}
@@ -0,0 +1,90 @@
+#!/bin/bash
+#
+# \file    check.sh
+#
+# \brief   Differential check of the register-interval creation algorithm: runs the program on examples/*.dot and check/inputs/*.dot
+#          with several register budgets and options and compares the output logs with the golden logs in check/golden/
+#          (check/inputs/ holds small CFGs for the cases that the examples do not cover, e.g. labels.dot has the labels ".L_1" and ".L_10")
+#          Usage: check/check.sh <RegisterIntervalCreation binary> [--update]
+#          With --update the golden logs are written again (after a change of the output that is intended).
+#
+# Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+
+if [ $# -lt 1 ]; then
+	echo "Usage: $0 <RegisterIntervalCreation binary> [--update]"
+	exit 1
+fi
+BINARY=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+UPDATE=0
+if [ "$2" == "--update" ]; then
+	UPDATE=1
+fi
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+GOLDEN=$ROOT/check/golden
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+#the cases: the name of the golden directory and the arguments (the register budget first)
+CASES=(
+	"text_8|8"
+	"text_16|16"
+	"text_32|32"
+	"sass_16|16 --format jsonl --sass"
+	"live_in_16|16 --format jsonl --live-in"
+	"frequency_16|16 --format jsonl --frequency"
+	"frequency_24|24 --format jsonl --frequency"
+	"loops_16|16 --format jsonl --loops"
+	"frequency_loops_16|16 --format jsonl --frequency --loops"
+	"plan_splits_8|8 --format jsonl --plan-splits"
+)
+
+failed=0
+for c in "${CASES[@]}"; do
+	name=${c%%|*}
+	arguments=${c#*|}
+	budget=${arguments%% *}
+	options=${arguments#$budget}
+
+	#the program writes its logs to output/ in the working directory
+	mkdir -p "$WORK/$name/output"
+	for f in "$ROOT"/examples/*.dot "$ROOT"/check/inputs/*.dot; do
+		if ! (cd "$WORK/$name" && "$BINARY" $budget "$f" $options > /dev/null); then
+			echo "FAIL $name: $(basename "$f") exited with an error"
+			failed=1
+		fi
+	done
+
+	if [ $UPDATE -eq 1 ]; then
+		rm -rf "$GOLDEN/$name"
+		mkdir -p "$GOLDEN"
+		cp -r "$WORK/$name/output" "$GOLDEN/$name"
+		echo "UPDATED $name"
+	elif diff -r "$GOLDEN/$name" "$WORK/$name/output" > "$WORK/$name.diff"; then
+		echo "PASS $name"
+	else
+		echo "FAIL $name: the logs differ from check/golden/$name"
+		head -20 "$WORK/$name.diff"
+		failed=1
+	fi
+done
+
+#regression: R4 holds the result of __cuda_sm20_div_rn_f32 in hotspot (".L_14: MOV R4, R2; RET;"), so it is live when the callee
+#returns and no register-interval of the callee may drop it without writing it back
+if [ $UPDATE -eq 0 ]; then
+	for mask in $(grep '__cuda_sm20_div_rn_f32"' "$WORK/sass_16/output/registerIntervals_hotspot_1.jsonl" | sed 's/.*"no_writeback":"\(0x[0-9a-f]*\)".*/\1/'); do
+		if [ $(( mask & 0x10 )) -ne 0 ]; then
+			echo "FAIL regression: the no-writeback mask $mask of __cuda_sm20_div_rn_f32 (hotspot) has its result register R4"
+			failed=1
+		fi
+	done
+
+	#regression: with --frequency pass two merges the register-interval of the loop of ".L_18" in cutcp (entry frequency 100) into the one of ".L_5"
+	#before ".L_5" joins the register-interval of ".L_19" (frequency 10), so at 24 registers the PREFETCH runs before the loop (23 weighted, not 123)
+	weighted=$(cd "$WORK" && "$BINARY" 24 "$ROOT/examples/cutcp.dot" --frequency | sed -n 's/.*#Weighted PREFETCHes = \([0-9.e+]*\).*/\1/p')
+	if [ "$weighted" != "23" ]; then
+		echo "FAIL regression: the weighted number of PREFETCH instructions of cutcp with 24 registers is $weighted (expected 23)"
+		failed=1
+	fi
+fi
+
+exit $failed
@@ -16,438 +16,431 @@
 #include <sstream>
 #include <vector>
 #include <set>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include <dirent.h>
+#include <sys/stat.h>
 
 //File includes
-#include "src/implementation/RegisterIntervalCreation.cpp"
+#include "src/implementation/Kernel.cpp"
+#include "src/implementation/ThreadPool.cpp"
 
 using namespace std;
 
-/* \brief This function gets the input file that contains the Graphviz Dot code of CFG and generates the basic blocks of application*/
-vector<basicBlock*> create_control_flow_graph(char* file_name);
+/* \brief runs the register-interval creation algorithm on one kernel and generates its logs (and its annotated SASS if sass is true;
+           natural loops are admitted as units if loop_admission is true and the split points of basic blocks are planned if split_planning is true; sets the number of final register-intervals, the weighted number
+           of PREFETCH instructions if weighting is not nullptr, the number of natural loops and of the contained ones and, if statistics is true,
+           the statistics of the kernel)*/
+void register_interval_creation(kernel& K, int REGNUM, registerBudget budget, const frequencyWeighting* weighting, bool loop_admission, bool split_planning, logFormat format, bool sass, bool statistics);
+
+/* \brief runs the register-interval creation algorithm on all kernels of the input files in parallel (largest files and kernels first)
+           and optionally reports the time of each file and the total time (and always the weighted number of PREFETCH instructions with weighting
+           and the number of natural loops that are contained in one register-interval with weighting or loop_admission);
+           if sass is true, the annotated SASS of each kernel is written too; if statistics_file is not empty, the statistics of all kernels
+           are printed and written to it as JSON*/
+int run_register_interval_creation(vector<string> files, int REGNUM, registerBudget budget, const frequencyWeighting* weighting, bool loop_admission, bool split_planning, int threads, bool report,
+                                   string cache_directory, logFormat format, bool sass, string statistics_file);
 
-/* \brief Splits abstract basic blocks to regular basic blocks*/
-vector<basicBlock*> split_abstract_basic_blocks(vector<basicBlock*>);
+/* \brief gets the .dot files of a directory (sorted by name) or the lines of a list file*/
+vector<string> input_files(const char* list);
 
-/* \brief generates a log that contains all information about the basic blocks and CFG (file: "basicBlocks.txt") */
-void basic_blocks_log(vector<basicBlock*> BBs, char* file_name);
+/* \brief gets the register budgets of a sweep: a comma-separated list of numbers and ranges "first:last[:step]" (e.g. "8,12,16:64:8")*/
+vector<int> register_budgets(const char* list);
 
-/* \brief generates a log that contains all information about the register-intervals and register-interval creation algorithm (file: "register-intervals_#{iteration}.txt") */
-void registerInterval_log(vector<registerInterval*> intervals, int iteration, char* file_name);
+/* \brief parses the input file once, creates the CFG of each kernel once and runs both passes for every register budget in parallel,
+           each on its own copy of the CFG, then prints one table (the logs are not generated)*/
+int run_register_budget_sweep(string file, vector<int> budgets, registerBudget budget, const frequencyWeighting* weighting, bool loop_admission, bool split_planning, int threads,
+                              string cache_directory);
 
 int main(int argc, char **argv)
 {
-	int REGNUM=atoi(argv[1]); //REGNUM is the allowed number of registers in register-intervals
-
-        //At first the graphviz dot code (the output of nvidisasm tool) will be parsed and the CFG will be generated.
-	vector<basicBlock*> basic_blocks = create_control_flow_graph(argv[2]);
-        
-        basic_blocks_log(basic_blocks, argv[2]);//generates a log file
-
-        //Register-interval creation algorithm (pass one) will construct the initial register-intervals from basic blocks and CFG
-	auto intervals = RegisterIntervalCreationPass::registerIntervalCreationPassOne(basic_blocks, REGNUM);
-
-        //In the following loop, pass two of register-interval creation algorithm will be repeated until no changes occur
-	int Size, i = 0;
-	do
-	{
-		registerInterval_log(intervals, i++, argv[2]);
-
-		Size = intervals.size();
-		intervals = RegisterIntervalCreationPass::registerIntervalCreationPassTwo(intervals, REGNUM);
-	} while (intervals.size() < Size); //Pass 2 of register-interval creation algorithm will be done until the CFG can not be reduced anymore
-
-	return 0;
-}
-
-vector<basicBlock*> create_control_flow_graph(char* file_name){
-    /* The control flow analysis of nvdisasm tool generates a CFG that its nodes are abstract basic blocks. So
-     we first extract the abstract basic blocks from graphviz dot code (the output of nvdisasm tool) and then  we will create basic blocks and CFG.*/
-    
-    vector<basicBlock*> abstract_basic_blocks;
-    
-    //**********************getting input file and finding abstract basic blocks*******************************
-        fstream file (file_name, fstream::in);
-        
-	char ch;
-	string cfgString;
-	string str = "";
-	bool start = false;
-	bool ready = false;
-	bool OK = false;
-	while (file >> noskipws >> ch)
-	{
-		cfgString = cfgString + ch;
-	}
-
-	for (int i = 0; i < cfgString.size(); i++){
-		if (start){
-			str = str + cfgString[i];
-		}
-
-		if (cfgString[i] == '"'){
-			if (!start){
-				start = true;
-			}
-			else{
-				ready = true;
-				start = false;
-			}
+	//the options can be given anywhere:
+	//"--cache <directory>": the CFGs are loaded from (and saved to) binary cache files in the directory
+	//"--format text|jsonl|csv": the format of the output logs
+	//"--stats <file>": the time of each step and the peak memory of the process (and the event counters, see make stats) are printed and written to the file as JSON
+	//"--live-in": the allowed number of registers limits only the live-in registers of register-intervals (the registers that are prefetched)
+	//"--frequency": the basic blocks are weighted by their execution frequency, estimated from loop nesting, and the weighted number of PREFETCH instructions is reported
+	//"--profile <file>": the same with the execution counts of the basic blocks in the file
+	//"--loops": a natural loop is added to a register-interval as a whole when its registers fit, so no PREFETCH runs in each iteration
+	//"--plan-splits": a basic block with too many registers is split into the fewest parts at once, instead of at the first instruction that does not fit
+	//"--sass": the code of each kernel is also written with a PREFETCH at the entry of each register-interval (output/AnnotatedSASS_*.sass)
+	string cache_directory;
+	registerBudget budget = BUDGET_ALL_REGISTERS;
+	string statistics_file;
+	logFormat format = LOG_TEXT;
+	bool sass = false;
+	bool weighted = false;
+	bool loop_admission = false;
+	bool split_planning = false;
+	executionProfile profile;
+	frequencyWeighting weighting;
+	weighting.profile = nullptr;
+	int n = 0;
+	for (int a = 0; a < argc; a++){
+		if (string(argv[a]) == "--cache" && a + 1 < argc)
+			cache_directory = argv[++a];
+		else if (string(argv[a]) == "--stats" && a + 1 < argc)
+			statistics_file = argv[++a];
+		else if (string(argv[a]) == "--live-in")
+			budget = BUDGET_LIVE_IN;
+		else if (string(argv[a]) == "--sass")
+			sass = true;
+		else if (string(argv[a]) == "--plan-splits")
+			split_planning = true;
+		else if (string(argv[a]) == "--loops")
+			loop_admission = true;
+		else if (string(argv[a]) == "--frequency")
+			weighted = true;
+		else if (string(argv[a]) == "--profile" && a + 1 < argc){
+			if (!profile.read(argv[++a]))
+				return 1;
+			weighted = true;
+			weighting.profile = &profile;
 		}
-
-		if (ready){
-			if (cfgString[i + 1] == '\n' || cfgString[i + 1] == 13){
-				OK = true;
-				ready = false;
-			}
+		else if (string(argv[a]) == "--format" && a + 1 < argc){
+			string f = argv[++a];
+			if (f == "text")
+				format = LOG_TEXT;
+			else if (f == "jsonl")
+				format = LOG_JSONL;
+			else if (f == "csv")
+				format = LOG_CSV;
 			else{
-				ready = false;
-				str = "";
+				cerr << "Unknown output format: " << f << " (text, jsonl or csv)" << endl;
+				return 1;
 			}
 		}
-
-		if (OK){
-			str.erase(str.size() - 1, 1);
-			auto temp = new basicBlock(str);
-			abstract_basic_blocks.push_back(temp);
-			OK = false;
-			str = "";
-		}
-	}
-	//******************************************************************************************
-
-	//***************************setting code of abstract basic blocks*************************************
-	int found1 = 0;
-	int found2 = 0;
-	string code;
-	for (int i = 0; i < abstract_basic_blocks.size(); i++){
-		code = "";
-		found1 = cfgString.find("<entry>", found1 + 1, 7);
-		found2 = cfgString.find("}\"]", found2 + 1, 3);
-		for (int j = found1; j < found2 - 2; j++){
-			code = code + cfgString[j];
-		}
-		abstract_basic_blocks[i]->set_code(code);
+		else
+			argv[n++] = argv[a];
 	}
-	//******************************************************************************************
-
-	//********************************Setting successors of abstract basic blocks******************************
-	size_t found = 0;
-	string tmp;
-	int count = 0;
-	for (int i = 0; i < abstract_basic_blocks.size(); i++){
-		str = "\"";
-		str = str + abstract_basic_blocks[i]->get_name();
-		str = str + "\"";
-		str = str + ":exit";
-		found = 0;
-		found = cfgString.find(str, found + 1);
-		while (found != string::npos){
-			count = 0;
-			tmp = "";
-			for (int j = found + 1; count < 3; j++){
-				if (count == 2){
-					tmp = tmp + cfgString[j];
-				}
+	argc = n;
 
-				if (cfgString[j] == '"')
-					count++;
-			}
-			tmp.erase(tmp.end() - 1);
-			for (int j = 0; j < abstract_basic_blocks.size(); j++){
-				if (abstract_basic_blocks[j]->get_name() == tmp){
-					abstract_basic_blocks[i]->add_successor(abstract_basic_blocks[j]);
-					break;
-				}
-			}
+	if (argc < 3){
+		cerr << "Usage: " << argv[0] << " <registers> <cfg.dot> [--cache <directory>] [--format text|jsonl|csv] [--stats <file.json>] [--live-in] [--frequency|--profile <file>] [--loops] [--plan-splits] [--sass]" << endl;
+		cerr << "       " << argv[0] << " <registers> --batch <directory|list file> [threads] [--cache <directory>] [--format text|jsonl|csv] [--stats <file.json>] [--live-in] [--frequency|--profile <file>] [--loops] [--plan-splits] [--sass]" << endl;
+		cerr << "       " << argv[0] << " <list|first:last[:step]> --sweep <cfg.dot> [threads] [--cache <directory>] [--live-in] [--frequency|--profile <file>] [--loops] [--plan-splits]" << endl;
+		return 1;
+	}
+	int REGNUM=atoi(argv[1]); //REGNUM is the allowed number of registers in register-intervals
 
-			found = cfgString.find(str, found + 1);
+	if (string(argv[2]) == "--sweep"){
+		vector<int> budgets = register_budgets(argv[1]);
+		if (argc < 4 || budgets.size() == 0){
+			cerr << "The sweep mode needs the register budgets (e.g. 8,12,16:64:8) and an input file" << endl;
+			return 1;
 		}
+		if (statistics_file.size() != 0)
+			cerr << "Warning: --stats is not used in the sweep mode" << endl;
+		if (sass)
+			cerr << "Warning: --sass is not used in the sweep mode" << endl;
+		return run_register_budget_sweep(argv[3], budgets, budget, weighted ? &weighting : nullptr, loop_admission, split_planning, argc > 4 ? atoi(argv[4]) : 0, cache_directory);
 	}
-	
-	count = 0;
-	for (int i = 0; i < abstract_basic_blocks.size(); i++){
-		str = "\"";
-		str = str + abstract_basic_blocks[i]->get_name();
-		str = str + "\"";
-		str = str + ":entry:s";
-		found = 0;
-		found = cfgString.find(str, found + 1);
-		while (found != string::npos){
-			count = 0;
-			tmp = "";
-			for (int j = found + 1; count < 3; j++){
-				if (count == 2){
-					tmp = tmp + cfgString[j];
-				}
-
-				if (cfgString[j] == '"')
-					count++;
-			}
-			tmp.erase(tmp.end() - 1);
-			for (int j = 0; j < abstract_basic_blocks.size(); j++){
-				if (abstract_basic_blocks[j]->get_name() == tmp){
-					abstract_basic_blocks[i]->add_successor(abstract_basic_blocks[j]);
-					break;
-				}
-			}
 
-			found = cfgString.find(str, found + 1);
+	if (string(argv[2]) == "--batch"){
+		if (argc < 4){
+			cerr << "The batch mode needs a directory or a list of input files" << endl;
+			return 1;
 		}
-	}
-	//************************************************************************************************
-
-	//********************************Setting predecessors of abstract basic blocks**********************************
-	vector<basicBlock*> x;
-	for (int i = 0; i < abstract_basic_blocks.size(); i++){
-		for (int j = 0; j < abstract_basic_blocks.size(); j++){
-			x = abstract_basic_blocks[j]->get_successors();
-			for (int k = 0; k < x.size(); k++){
-				if (x[k]->get_name() == abstract_basic_blocks[i]->get_name()){
-					abstract_basic_blocks[i]->add_predecessor(abstract_basic_blocks[j]);
-				}
-			}
+		vector<string> files = input_files(argv[3]);
+		if (files.size() == 0){
+			cerr << "No input files in " << argv[3] << endl;
+			return 1;
 		}
+		return run_register_interval_creation(files, REGNUM, budget, weighted ? &weighting : nullptr, loop_admission, split_planning, argc > 4 ? atoi(argv[4]) : 0, true, cache_directory, format, sass, statistics_file);
 	}
-	//************************************************************************************************
-	
-	//**************************Splitting abstract basic blocks to regular basic blocks***********************************
-	auto basic_blocks = split_abstract_basic_blocks(abstract_basic_blocks);
-	
-	//***********************Extracting Registers of each basicBlock***************************************
-	found = 0;
-	for (int i = 0; i < basic_blocks.size(); i++){
-		found = 0;
-		code = basic_blocks[i]->get_code();
-		found = code.find("R", found + 1, 1);
-		while (found != string::npos){
-			str = "R";
-			if (code[found + 1] > 47 && code[found + 1] < 58){
-				for (int j = found + 1; code[j] >47 && code[j] < 58; j++){
-					str = str + code[j];
-				}
-				basic_blocks[i]->add_register(str);
-			}
 
-			found = code.find("R", found + 1, 1);
-		}
-	}
-	//************************************************************************************************
-        
-        return basic_blocks;
+	return run_register_interval_creation(vector<string>(1, argv[2]), REGNUM, budget, weighted ? &weighting : nullptr, loop_admission, split_planning, 0, false, cache_directory, format, sass, statistics_file);
 }
 
-vector<basicBlock*> split_abstract_basic_blocks(vector<basicBlock*> ABBs){
-	basicBlock *temp, *temp2;
-	vector<basicBlock*> controling_basicBlocks;
-	string q = "Controling_basicBlock";
-	int p = 0;
-        
-        vector<basicBlock*> basic_blocks;
-
-	//**********************Splitting Codes and Constructing new BBs***********************
-	string str, str2;
-	int found1 = 0;
-	int found2 = 0;
-	int foundtemp = 0;
-	int foundExit = 0;
-	for(int i = 0; i < ABBs.size(); i++){
-		str = ABBs[i]->get_code();
-		char tt = 'A';
-		found1 = 0;
-		found2 = str.find("<exit", found1);
-		
-		while(found2 != string::npos){
-			str2.clear();
-			for(int j = found1; j < found2; j++){
-				str2 = str2 + str[j];
-			}
-
-			foundExit = str2.find("EXIT", 0);
-			foundtemp = str2.find(";", 0);
-
-			if(foundExit == string::npos){
-				if(str2.find(";", foundtemp + 1) == string::npos && str2.find("@P0", 0) != string::npos){
-					temp2 = new basicBlock();
-					temp2->set_code(str2);
-					temp2->set_name(q + std::to_string(p));
-					p++;
-					temp2->set_controling();
-					controling_basicBlocks.push_back(temp2);
+void register_interval_creation(kernel& K, int REGNUM, registerBudget budget, const frequencyWeighting* weighting, bool loop_admission, bool split_planning, logFormat format, bool sass, bool statistics){
+	auto begin = chrono::steady_clock::now();
+	runStatistics* S = statistics ? &K.statistics : nullptr;
+	runStatistics::clear_counters(); //the counters of the thread are taken after the kernel
+	controlFlowGraph graph; //owns the basic blocks and register-intervals
 
-					temp->set_control_basicBlock(temp2);
-				}
-				else{
-					temp = new basicBlock(ABBs[i]->getID());
-					temp->set_code(str2);
-					if(found1 == 0)
-						temp->set_name(ABBs[i]->get_name());
-					else{
-						temp->set_name(ABBs[i]->get_name()+tt);
-						tt++;
-					}
-					basic_blocks.push_back(temp);
-				}
-			}
+        //At first the CFG of the kernel will be generated from the graphviz dot code (the output of nvidisasm tool).
+	vector<basicBlock*> basic_blocks = kernel_basic_blocks(K, graph, S);
+        
+	auto step = chrono::steady_clock::now();
+	if (format == LOG_TEXT)
+		basic_blocks_log(basic_blocks, K);//generates a log file
+	double output_time = chrono::duration<double, milli>(chrono::steady_clock::now() - step).count();
+
+	double pass_time[2] = {0, 0};
+	frequencyWeighting W; //the weighting of this kernel
+	if (weighting != nullptr){
+		W = *weighting;
+		W.kernel = K.function;
+	}
+	int loop_count[2] = {0, 0};
+	auto intervals = register_interval_passes(graph, basic_blocks, REGNUM, budget, weighting != nullptr ? &W : nullptr, loop_admission, split_planning, pass_time, &K.weighted_prefetches, loop_count, S);
+	K.loops = loop_count[0];
+	K.contained_loops = loop_count[1];
+	step = chrono::steady_clock::now();
+	if (format == LOG_TEXT)
+		registerInterval_log(intervals, K);
+	else
+		structured_logs(graph, intervals, K, format);
+	if (sass)
+		annotated_sass_log(graph, intervals, K, budget);
+	if (S != nullptr){
+		S->add_phase("output", output_time + chrono::duration<double, milli>(chrono::steady_clock::now() - step).count());
+		S->take_counters();
+	}
 
-			found1 = found2+1;
-			found2 = str.find("<exit", found1);
-		}
+	K.intervals = intervals.size();
+	K.time = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+}
 
-		str2.clear();
-		for(int j = found1; j < str.size(); j++){
-			str2 = str2 + str[j];
-		}
+int run_register_interval_creation(vector<string> files, int REGNUM, registerBudget budget, const frequencyWeighting* weighting, bool loop_admission, bool split_planning, int threads, bool report,
+                                   string cache_directory, logFormat format, bool sass, string statistics_file){
+	auto start = chrono::steady_clock::now();
+	threadPool pool(threads);
 
-		foundExit = str2.find("EXIT", 0);
-		foundtemp = str2.find(";", 0);
-		if(foundExit == string::npos){
-			if(str2.find(";", foundtemp + 1) == string::npos && str2.find("@P0", 0) != string::npos){
-				temp2 = new basicBlock();
-				temp2->set_code(str2);
-				temp2->set_name(q + std::to_string(p));
-				p++;
-				temp2->set_controling();
-				controling_basicBlocks.push_back(temp2);
-
-				temp->set_control_basicBlock(temp2);
-			}
-			else{
-				temp = new basicBlock(ABBs[i]->getID());
-				temp->set_code(str2);
-				if(found1 == 0)
-					temp->set_name(ABBs[i]->get_name());
-				else{
-					temp->set_name(ABBs[i]->get_name()+tt);
-					tt++;
-				}
-				basic_blocks.push_back(temp);
-			}
-		}
+	//the largest files (and kernels) are scheduled first, so a large one does not start when the other threads are about to finish
+	vector<pair<long long, int>> order;
+	for (int f = 0; f < files.size(); f++){
+		struct stat st;
+		order.push_back(make_pair(stat(files[f].c_str(), &st) == 0 ? (long long)st.st_size : 0LL, f));
+	}
+	sort(order.begin(), order.end(), [](const pair<long long, int>& a, const pair<long long, int>& b){ return a.first > b.first || (a.first == b.first && a.second < b.second); });
+
+	//**********************parsing the input files*******************************
+	vector<inputFile*> inputs(files.size());
+	for (int k = 0; k < order.size(); k++){
+		int f = order[k].second;
+		inputs[f] = new inputFile();
+		inputs[f]->name = files[f];
+		pool.submit([&inputs, f, &cache_directory]{ parse_input_file(*inputs[f], cache_directory); });
+	}
+	pool.wait();
+	for (int f = 0; f < files.size(); f++){
+		if (sass && inputs[f]->cached)//the annotated SASS is written from the Dot nodes, which are not parsed when the CFGs are loaded from the cache
+			DotParser::parse(inputs[f]->file, inputs[f]->nodes, inputs[f]->edges);
+	}
+	runStatistics statistics; //the steps of all files and kernels are added (with several threads they overlap)
+	if (statistics_file.size() != 0){
+		double parse_time = 0;
+		for (int f = 0; f < files.size(); f++)
+			parse_time += inputs[f]->time;
+		statistics.add_phase("parse", parse_time);
 	}
-	//***********************************************************************************
-
-	//*********************Setting Predecessors and Successors***************************
-	vector<basicBlock*> P, S;
-	bool isNextBB;
-	int firstID;
-	int lastID;
-	string name;
-	for(int i = 0; i < ABBs.size(); i++){
-		P = ABBs[i]->get_predecessors();
-		S = ABBs[i]->get_successors();
-
-		int count = 0;
-		for(int k = 0; k < basic_blocks.size(); k++){
-			if(basic_blocks[k]->get_ABB() == ABBs[i]->getID()){
-				if(count == 0)
-					firstID = k;
-				count++;
-			}
-		}
-		lastID = firstID + count - 1;
-
 
-		for(int j = 0; j < S.size(); j++){
-			if(S[j]->getID() == ABBs[i]->getID()+1){
-				basic_blocks[lastID]->add_successor(basic_blocks[lastID+1]);
-				basic_blocks[lastID+1]->add_predecessor(basic_blocks[lastID]);
+	//**********************register-interval creation of all kernels*******************************
+	vector<vector<kernel>> kernels(files.size());
+	vector<pair<size_t, pair<int, int>>> kernel_order; //(size, (file, kernel))
+	for (int f = 0; f < files.size(); f++){
+		kernels[f] = find_kernels(inputs[f]);
+		for (int k = 0; k < kernels[f].size(); k++)
+			kernel_order.push_back(make_pair(kernels[f][k].size, make_pair(f, k)));
+	}
+	sort(kernel_order.begin(), kernel_order.end(), [](const pair<size_t, pair<int, int>>& a, const pair<size_t, pair<int, int>>& b){ return a.first > b.first || (a.first == b.first && a.second < b.second); });
+	for (int k = 0; k < kernel_order.size(); k++){
+		kernel* K = &kernels[kernel_order[k].second.first][kernel_order[k].second.second];
+		bool statistics = statistics_file.size() != 0;
+		pool.submit([K, REGNUM, budget, weighting, loop_admission, split_planning, format, sass, statistics]{
+			register_interval_creation(*K, REGNUM, budget, weighting, loop_admission, split_planning, format, sass, statistics);
+		});
+	}
+	pool.wait();
+	for (int f = 0; f < files.size(); f++)
+		write_cache_file(*inputs[f], kernels[f]);
+
+	//**********************reporting*******************************
+	int failed = 0;
+	for (int f = 0; f < files.size(); f++){
+		failed += !inputs[f]->valid;
+		if (report || weighting != nullptr || loop_admission){
+			int intervals = 0, loops = 0, contained_loops = 0;
+			double time = inputs[f]->time, weighted_prefetches = 0;
+			for (int k = 0; k < kernels[f].size(); k++){
+				intervals += kernels[f][k].intervals;
+				time += kernels[f][k].time;
+				weighted_prefetches += kernels[f][k].weighted_prefetches;
+				loops += kernels[f][k].loops;
+				contained_loops += kernels[f][k].contained_loops;
 			}
+			cout << " #File = " << files[f] << " #Kernels = " << kernels[f].size() << " #Register-intervals = " << intervals;
+			if (weighting != nullptr)
+				cout << " #Weighted PREFETCHes = " << weighted_prefetches;
+			if (weighting != nullptr || loop_admission)
+				cout << " #Loops = " << loops << " #Contained loops = " << contained_loops;
+			cout << " #Time = " << time << " ms" << endl;
 		}
+	}
+	if (report){
+		double total = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+		cout << "The number of files = " << files.size() << " #Threads = " << pool.size() << " #Total time = " << total << " ms" << endl;
+	}
+	if (statistics_file.size() != 0){
+		for (int f = 0; f < files.size(); f++)
+			for (int k = 0; k < kernels[f].size(); k++)
+				statistics.add(kernels[f][k].statistics);
+		statistics.print_table();
+		if (!statistics.write_json(statistics_file))
+			cerr << "Warning: cannot write the statistics file " << statistics_file << endl;
+	}
 
-		for(int j = firstID; j < lastID; j++){
-			basic_blocks[j]->add_successor(basic_blocks[j+1]);
-			basic_blocks[j+1]->add_predecessor(basic_blocks[j]);
-		}
+	for (int f = 0; f < files.size(); f++)
+		delete inputs[f];
+	return failed == 0 ? 0 : 1;
+}
 
-		for(int j = firstID; j <= lastID; j++){
-			if(basic_blocks[j]->get_controling_basicBlock() != nullptr){
-				str = (basic_blocks[j]->get_controling_basicBlock())->get_code();
-				for(int k = 0; k < basic_blocks.size(); k++){
-					name = basic_blocks[k]->get_name();
-					if(str.find(name, 0) != string::npos && name.size() != 0){
-						basic_blocks[j]->add_successor(basic_blocks[k]);
-						basic_blocks[k]->add_predecessor(basic_blocks[j]);
-					}
-				}
-			}
-		}
+vector<int> register_budgets(const char* list){
+	vector<int> budgets;
+	stringstream in(list);
+	string item;
+	while (getline(in, item, ',')){
+		int first, last, step = 1;
+		char extra;
+		int n = sscanf(item.c_str(), "%d:%d:%d%c", &first, &last, &step, &extra);
+		if (n == 1 && item.find(':') == string::npos)
+			last = first;
+		else if (n != 2 && n != 3)
+			return vector<int>();
+		if (first <= 0 || step <= 0 || last < first)
+			return vector<int>();
+		for (int N = first; N <= last; N += step)
+			budgets.push_back(N);
 	}
-        
-        return basic_blocks;
+	return budgets;
 }
 
-void basic_blocks_log(vector<basicBlock*> basic_blocks, char* file_name){
-	std::string File(file_name);
-	int p = File.find("/");
-	int p1 = p;
-	while(p != string::npos){
-		p1 = p;
-		p = File.find("/", p + 1);
+int run_register_budget_sweep(string file, vector<int> budgets, registerBudget budget, const frequencyWeighting* weighting, bool loop_admission, bool split_planning, int threads,
+                              string cache_directory){
+	auto start = chrono::steady_clock::now();
+	threadPool pool(threads);
+
+	inputFile input;
+	input.name = file;
+	parse_input_file(input, cache_directory);
+	if (!input.valid)
+		return 1;
+	vector<kernel> kernels = find_kernels(&input);
+
+	//**********************creating the CFG of each kernel once (the snapshots)*******************************
+	vector<controlFlowGraph*> snapshots(kernels.size());
+	for (int k = 0; k < kernels.size(); k++){
+		snapshots[k] = new controlFlowGraph();
+		pool.submit([&kernels, &snapshots, k]{ kernel_basic_blocks(kernels[k], *snapshots[k], nullptr); });
 	}
-	int p2 = File.find(".");
-	File = File.substr(p1 + 1, p2 - p1 - 1);
-        std::ofstream out("output/BasicBlocks_" + File + ".txt");
-        
-        vector<basicBlock*> P ,S;
-	out << "The number of basic_blocks = " << basic_blocks.size() << endl;
-	for (int i = 0; i < basic_blocks.size(); i++){
-		out << " #The basic_block ID : " << basic_blocks[i]->getID() << endl;
-		out << "		#Number of Instructions = " << basic_blocks[i]->numberOfInstructions() << endl;
-		out << "		#Register_list = {";
-		set<string> L = basic_blocks[i]->get_output_list();
-		set<string>::iterator it;
-		for (it = L.begin(); it != L.end(); it++)
-			out << *it << " ";
-		out << "}; #Number of Registers = " << L.size() << ";" << endl;
-		P = basic_blocks[i]->get_predecessors();
-		S = basic_blocks[i]->get_successors();
-		out << "		#predecessors = {";
-		for(int j=0;j<P.size();j++){
-			out << P[j]->getID() << " ";
+	pool.wait();
+	write_cache_file(input, kernels);
+
+	//**********************register-interval creation for every (register budget, kernel) on a copy of the snapshot*******************************
+	struct sweepResult
+	{
+		int intervals;
+		double registers;    //the average number of registers of the final register-intervals
+		double live_in;      //the average number of their live-in registers
+		double no_writeback; //the average number of their no-writeback registers
+		double weighted_prefetches; //the weighted number of PREFETCH instructions that run (only with frequency weighting)
+		int loop_count[2];   //the number of natural loops and of the loops that are contained in one register-interval
+		double pass_time[2]; //the time of pass one and pass two (ms)
+	};
+	vector<vector<sweepResult>> results(budgets.size(), vector<sweepResult>(kernels.size()));
+	vector<pair<size_t, int>> kernel_order; //(size, kernel): the largest kernels are scheduled first
+	for (int k = 0; k < kernels.size(); k++)
+		kernel_order.push_back(make_pair(kernels[k].size, k));
+	sort(kernel_order.begin(), kernel_order.end(), [](const pair<size_t, int>& a, const pair<size_t, int>& b){ return a.first > b.first || (a.first == b.first && a.second < b.second); });
+	for (int o = 0; o < kernel_order.size(); o++){
+		int k = kernel_order[o].second;
+		for (int b = 0; b < budgets.size(); b++){
+			pool.submit([&snapshots, &budgets, &results, &kernels, budget, weighting, loop_admission, split_planning, k, b]{
+				controlFlowGraph graph;
+				graph.copy_basicBlocks(*snapshots[k]);
+				vector<basicBlock*> basic_blocks(graph.number_of_basicBlocks());
+				for (int ID = 0; ID < basic_blocks.size(); ID++)
+					basic_blocks[ID] = graph.basic_block(ID);
+
+				sweepResult& R = results[b][k];
+				R.pass_time[0] = R.pass_time[1] = R.weighted_prefetches = 0;
+				R.loop_count[0] = R.loop_count[1] = 0;
+				frequencyWeighting W; //the weighting of this kernel
+				if (weighting != nullptr){
+					W = *weighting;
+					W.kernel = kernels[k].function;
+				}
+				auto intervals = register_interval_passes(graph, basic_blocks, budgets[b], budget, weighting != nullptr ? &W : nullptr, loop_admission, split_planning, R.pass_time, &R.weighted_prefetches,
+				                                          R.loop_count, nullptr);
+				R.intervals = intervals.size();
+				R.registers = R.live_in = R.no_writeback = 0;
+				for (int i = 0; i < intervals.size(); i++){
+					R.registers += intervals[i]->get_register_list().size();
+					R.live_in += intervals[i]->get_live_in_list().size();
+					R.no_writeback += intervals[i]->get_no_writeback_list().size();
+				}
+				if (intervals.size() != 0){
+					R.registers /= intervals.size();
+					R.live_in /= intervals.size();
+					R.no_writeback /= intervals.size();
+				}
+			});
 		}
-		out << "};		#successors = {";
-		for(int j=0;j<S.size();j++){
-			out << S[j]->getID() << " ";
+	}
+	pool.wait();
+
+	//**********************reporting*******************************
+	printf("The file = %s #Kernels = %d #Threads = %d\n", file.c_str(), (int)kernels.size(), pool.size());
+	printf("%10s %20s %16s %16s %18s %16s %16s", "#Registers", "#Register-intervals", "#Avg registers", "#Avg live-in", "#Avg no-writeback", "#Pass one (ms)", "#Pass two (ms)");
+	if (weighting != nullptr)
+		printf(" %22s", "#Weighted PREFETCHes");
+	printf(weighting != nullptr || loop_admission ? " %18s\n" : "\n", "#Contained loops");
+	for (int b = 0; b < budgets.size(); b++){
+		int intervals = 0;
+		int contained_loops = 0;
+		double registers = 0, live_in = 0, no_writeback = 0, weighted_prefetches = 0, pass_time[2] = {0, 0};
+		for (int k = 0; k < kernels.size(); k++){
+			intervals += results[b][k].intervals;
+			registers += results[b][k].registers * results[b][k].intervals;
+			live_in += results[b][k].live_in * results[b][k].intervals;
+			no_writeback += results[b][k].no_writeback * results[b][k].intervals;
+			weighted_prefetches += results[b][k].weighted_prefetches;
+			contained_loops += results[b][k].loop_count[1];
+			pass_time[0] += results[b][k].pass_time[0];
+			pass_time[1] += results[b][k].pass_time[1];
 		}
-		out <<"};" << endl;
+		printf("%10d %20d %16.2f %16.2f %18.2f %16.3f %16.3f", budgets[b], intervals, intervals != 0 ? registers / intervals : 0.0,
+		       intervals != 0 ? live_in / intervals : 0.0, intervals != 0 ? no_writeback / intervals : 0.0, pass_time[0], pass_time[1]);
+		if (weighting != nullptr)
+			printf(" %22.0f", weighted_prefetches);
+		printf(weighting != nullptr || loop_admission ? " %18d\n" : "\n", contained_loops);
 	}
+	printf("The parsing time = %.3f ms #Total time = %.3f ms\n", input.time, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+
+	for (int k = 0; k < kernels.size(); k++)
+		delete snapshots[k];
+	return 0;
 }
 
-void registerInterval_log(vector<registerInterval*> intervals, int iteration, char* file_name){
-	std::string File(file_name);
-	int p = File.find("/");
-	int p1 = p;
-	while(p != string::npos){
-		p1 = p;
-		p = File.find("/", p + 1);
-	}
-	int p2 = File.find(".");
-	File = File.substr(p1 + 1, p2 - p1 - 1);
-        std::ofstream out("output/registerIntervals_" + File + ".txt");
-        
-	out << "The number of Intervals = " << intervals.size() << endl;
-	for (int i = 0; i < intervals.size(); i++){
-		out << " #Interval ID = " << intervals[i]->getID() << " #Number of Instructions = " << intervals[i]->getNumberOfInstructions() << endl;
-		out << "		 #Register_list = {";
-		set<string> L = intervals[i]->get_register_list();
-		set<string>::iterator it;
-		for (it = L.begin(); it != L.end(); it++)
-			out << *it << " ";
-		out << "}; #Number of Registers = " << L.size() << ";" << endl;
-			
-		vector<registerInterval*> ii;
-
-		ii = intervals[i]->get_predecessors();
-		out <<"		Predecessors = { ";
-		for(int j = 0; j < ii.size(); j++){
-			out << ii[j]->getID() << " ";
+vector<string> input_files(const char* list){
+	vector<string> files;
+	string path(list);
+
+	DIR* directory = opendir(list);
+	if (directory != nullptr){
+		struct dirent* entry;
+		while ((entry = readdir(directory)) != nullptr){
+			string name(entry->d_name);
+			if (name.size() > 4 && name.compare(name.size() - 4, 4, ".dot") == 0)
+				files.push_back(path + "/" + name);
 		}
+		closedir(directory);
+		sort(files.begin(), files.end());
+		return files;
+	}
 
-		ii = intervals[i]->get_successors();
-		out << "}		Successors = { ";
-		for(int j = 0; j < ii.size(); j++){
-			out << ii[j]->getID() << " ";
-		}
-		out << "};" << endl;
+	ifstream in(list);
+	string line;
+	while (getline(in, line)){
+		while (line.size() != 0 && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t'))
+			line.pop_back();
+		if (line.size() != 0)
+			files.push_back(line);
 	}
+	return files;
 }
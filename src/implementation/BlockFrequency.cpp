@@ -0,0 +1,108 @@
+/*
+ * \file    BlockFrequency.cpp
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Implementation of the execution frequency of basic blocks
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "../interface/BlockFrequency.h"
+
+using namespace std;
+
+//******************************************executionProfile Methods**************************************
+bool executionProfile::read(const string& file){
+	ifstream in(file.c_str());
+	if (!in){
+		cerr << "Cannot open the profile file: " << file << endl;
+		return false;
+	}
+	string line;
+	int number = 0;
+	while (getline(in, line)){
+		number++;
+		istringstream fields(line);
+		vector<string> F;
+		string f;
+		while (fields >> f)
+			F.push_back(f);
+		if (F.size() == 0 || F[0][0] == '#')
+			continue;
+
+		char* end = nullptr;
+		double count = F.size() >= 2 ? strtod(F.back().c_str(), &end) : -1;
+		if (F.size() > 3 || end == nullptr || *end != '\0' || count < 0){
+			cerr << "Invalid line " << number << " in the profile file " << file << ": " << line << endl;
+			return false;
+		}
+		counts[(F.size() == 3 ? F[0] : "") + "\n" + F[F.size() - 2]] = count;
+	}
+	return true;
+}
+
+bool executionProfile::find(const string& kernel, const string& block, double& count) const{
+	auto c = counts.find(kernel + "\n" + block);
+	if (c == counts.end())
+		c = counts.find("\n" + block);
+	if (c == counts.end())
+		return false;
+	count = c->second;
+	return true;
+}
+
+
+//******************************************blockFrequency Methods**************************************
+void blockFrequency::estimate(const vector<basicBlock*>& blocks, const loopForest& loops){
+	frequencies.clear();
+	for (auto b = blocks.begin(); b != blocks.end(); b++){
+		int x = (*b)->getID();
+		if (x >= (int)frequencies.size())
+			frequencies.resize(x + 1, 1);
+		frequencies[x] = pow((double)LOOP_WEIGHT, loops.depth(*b));
+	}
+}
+
+void blockFrequency::read_profile(const vector<basicBlock*>& blocks, const executionProfile& profile, const string& kernel){
+	frequencies.clear();
+	vector<bool> found;
+	unordered_map<int, double> ABB_count; //the count of the first basic block of each abstract basic block that is in the profile
+	for (auto b = blocks.begin(); b != blocks.end(); b++){
+		int x = (*b)->getID();
+		if (x >= (int)frequencies.size()){
+			frequencies.resize(x + 1, 0);
+			found.resize(x + 1, false);
+		}
+		found[x] = profile.find(kernel, (*b)->get_name(), frequencies[x]);
+		if (found[x] && ABB_count.count((*b)->get_ABB()) == 0)
+			ABB_count[(*b)->get_ABB()] = frequencies[x];
+	}
+	for (auto b = blocks.begin(); b != blocks.end(); b++){
+		int x = (*b)->getID();
+		auto c = ABB_count.find((*b)->get_ABB());
+		if (!found[x] && c != ABB_count.end())
+			frequencies[x] = c->second;
+	}
+}
+
+void blockFrequency::split(basicBlock* b, basicBlock* second){
+	int y = second->getID();
+	if (y >= (int)frequencies.size())
+		frequencies.resize(y + 1, 0);
+	frequencies[y] = frequency(b);
+}
+
+double blockFrequency::frequency(basicBlock* b) const{
+	int x = b->getID();
+	return x < (int)frequencies.size() ? frequencies[x] : 0;
+}
@@ -10,16 +10,84 @@
  * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
  */
 
+#include <algorithm>
+#include <new>
+
 #include "../interface/ControlFlowGraph.h"
 
 using namespace std;
 
-//******************************************registerInterval Methods**************************************
-int registerInterval::IDgenerator = 0;
+//******************************************neighbourList Methods**************************************
+template<typename T>
+neighbourList<T>::neighbourList(const objectPool<T>* p, int o, int l){
+	pool = p;
+	offset = o;
+	length = l;
+}
+
+template<typename T>
+typename neighbourList<T>::iterator neighbourList<T>::begin() const{
+	return iterator(pool, offset);
+}
+
+template<typename T>
+typename neighbourList<T>::iterator neighbourList<T>::end() const{
+	return iterator(pool, offset + length);
+}
+
+template<typename T>
+int neighbourList<T>::size() const{
+	return length;
+}
+
+template<typename T>
+T* neighbourList<T>::operator[](int i) const{
+	return pool->get(pool->edge(offset + i));
+}
+
+template<typename T>
+neighbourList<T>::iterator::iterator(const objectPool<T>* p, int i){
+	pool = p;
+	index = i;
+}
+
+template<typename T>
+T* neighbourList<T>::iterator::operator*() const{
+	return pool->get(pool->edge(index));
+}
+
+template<typename T>
+typename neighbourList<T>::iterator& neighbourList<T>::iterator::operator++(){
+	index++;
+	return *this;
+}
+
+template<typename T>
+typename neighbourList<T>::iterator neighbourList<T>::iterator::operator++(int){
+	iterator old = *this;
+	index++;
+	return old;
+}
+
+template<typename T>
+bool neighbourList<T>::iterator::operator==(const iterator& other) const{
+	return index == other.index;
+}
+
+template<typename T>
+bool neighbourList<T>::iterator::operator!=(const iterator& other) const{
+	return index != other.index;
+}
 
-registerInterval::registerInterval(){
-	ID = IDgenerator++;
+//******************************************registerInterval Methods**************************************
+registerInterval::registerInterval(int id){
+	ID = id;
+	pool = nullptr;
+	predecessors_offset = predecessors_length = 0;
+	successors_offset = successors_length = 0;
+	next_level_registerInterval = nullptr;
 	registerInterval_numberOfInstructions = 0;
+	code_length = 0;
 }
 
 registerInterval::~registerInterval(){}
@@ -32,76 +100,92 @@ int registerInterval::getNumberOfInstructions(){
 	return registerInterval_numberOfInstructions;
 }
 
-void registerInterval::set_code(string s){
-	code = s;
-	registerInterval_numberOfInstructions = 0;
+void registerInterval::add_code(codeRange r){
+	code.push_back(r);
+	registerInterval_numberOfInstructions += r.count(';');
+	if (code_length == 0 && r.size() != 0 && *r.begin == ';')//a ";" at the very beginning of the instructions is not counted
+		registerInterval_numberOfInstructions--;
+	code_length += r.size();
+}
 
-	int found = 0;
-	found = code.find(";", found + 1, 1);
-	while (found != string::npos){
-		registerInterval_numberOfInstructions++;
-		found = code.find(";", found + 1, 1);
-	}
+void registerInterval::add_code(const vector<codeRange>& ranges){
+	for (int i = 0; i < ranges.size(); i++)
+		add_code(ranges[i]);
 }
 
-string registerInterval::get_code(){
+const vector<codeRange>& registerInterval::get_code(){
 	return code;
 }
 
-set<string> registerInterval::get_register_list(){
-	return register_list;
+string registerInterval::code_text(){
+	string text;
+	for (int i = 0; i < code.size(); i++)
+		text.append(code[i].begin, code[i].size());
+	return text;
 }
 
-vector<bool> registerInterval::get_register_vector(){
-	return register_vector;
+registerSet registerInterval::get_register_list(){
+	return register_list;
 }
 
-void registerInterval::set_register_list(set<string> s){
+void registerInterval::set_register_list(registerSet s){
 	register_list = s;
+}
 
-	int pos;
-	string str;
-	set<string>::iterator it;
-	for(int i = 0; i < 64; i++){
-		register_vector.push_back(false);
-	}
+void registerInterval::set_entry_live_list(registerSet s){
+	entry_live_list = s;
+}
 
-	for(it = register_list.begin(); it != register_list.end(); ++it){
-		str = *it;
-		str.erase(str.begin());
-		pos = stoi(str);
-		register_vector[pos] = true;
-	}
+registerSet registerInterval::get_entry_live_list(){
+	return entry_live_list;
 }
 
-void registerInterval::add_predecessor(registerInterval* i){
-	bool found = false;
-	for (int j = 0; j < predecessors.size(); j++){
-		if (predecessors[j] == i)
-			found = true;
-	}
+registerSet registerInterval::get_live_in_list(){
+	registerSet s = register_list;
+	s.intersect(entry_live_list);
+	return s;
+}
+
+void registerInterval::set_exit_live_list(registerSet s){
+	exit_live_list = s;
+}
+
+registerSet registerInterval::get_exit_live_list(){
+	return exit_live_list;
+}
 
-	if (!found)
-		predecessors.push_back(i);
+registerSet registerInterval::get_no_writeback_list(){
+	registerSet s = register_list;
+	s.remove(exit_live_list);
+	return s;
+}
+
+void registerInterval::set_pool(objectPool<registerInterval>* p){
+	pool = p;
+}
+
+void registerInterval::add_predecessor(registerInterval* i){
+	pool->append_edge(predecessors_offset, predecessors_length, i->getID());
 }
 
 void registerInterval::add_successors(registerInterval* i){
-	bool found = false;
-	for (int j = 0; j < successors.size(); j++){
-		if (successors[j] == i)
-			found = true;
-	}
+	pool->append_edge(successors_offset, successors_length, i->getID());
+}
 
-	if (!found)
-		successors.push_back(i);
+void registerInterval::add_basic_block(basicBlock* b){
+	blocks.push_back(b);
 }
 
-vector<registerInterval*> registerInterval::get_predecessors(){
-	return predecessors;
+const vector<basicBlock*>& registerInterval::get_basic_blocks(){
+	return blocks;
 }
 
-vector<registerInterval*> registerInterval::get_successors(){
-	return successors;
+neighbourList<registerInterval> registerInterval::get_predecessors(){
+	return neighbourList<registerInterval>(pool, predecessors_offset, predecessors_length);
+}
+
+neighbourList<registerInterval> registerInterval::get_successors(){
+	return neighbourList<registerInterval>(pool, successors_offset, successors_length);
 }
 
 void registerInterval::set_next_level_registerInterval(registerInterval* i){
@@ -113,33 +197,49 @@ registerInterval* registerInterval::nextLevelInterval(){
 }
 
 //*******************************************basicBlock Methods****************************************
-int basicBlock::IDgenerator = 0;
-int basicBlock::IDgenerator2 = 0;
-
-basicBlock::basicBlock(){
-	ID = IDgenerator++;
+basicBlock::basicBlock(int id){
+	ID = id;
+	ABB = -1;
 	NumberOfInstructions = 0;
+	first = last = 0;
 	controlBB = false;
+	exit_state = false;
 	controling_basicBlock = nullptr;
+	BB_registerInterval = nullptr;
+	pool = nullptr;
+	predecessors_offset = predecessors_length = 0;
+	successors_offset = successors_length = 0;
 }
 
 basicBlock::~basicBlock(){}
 
-basicBlock::basicBlock(string s){
-	ID = IDgenerator++;
+basicBlock::basicBlock(int id, string s){
+	ID = id;
 	name = s;
+	ABB = -1;
 	NumberOfInstructions = 0;
+	first = last = 0;
 	controlBB = false;
+	exit_state = false;
 	controling_basicBlock = nullptr;
+	BB_registerInterval = nullptr;
+	pool = nullptr;
+	predecessors_offset = predecessors_length = 0;
+	successors_offset = successors_length = 0;
 }
 
-basicBlock::basicBlock(int i){
-	ID = IDgenerator2++;
+basicBlock::basicBlock(int id, int i){
+	ID = id;
 	ABB = i;
 	NumberOfInstructions = 0;
+	first = last = 0;
 	controlBB = false;
 	exit_state = false;
 	controling_basicBlock = nullptr;
+	BB_registerInterval = nullptr;
+	pool = nullptr;
+	predecessors_offset = predecessors_length = 0;
+	successors_offset = successors_length = 0;
 }
 
 void basicBlock::set_name(string s)
@@ -147,64 +247,87 @@ void basicBlock::set_name(string s)
 	name = s;
 }
 
-void basicBlock::set_code(string s)
+void basicBlock::set_code(codeRange r)
 {
-	code = s;
-	NumberOfInstructions = 0;
-
-	int found = 0;
-	found = code.find(";", found + 1, 1);
-	while (found != string::npos){
-		NumberOfInstructions++;
-		found = code.find(";", found + 1, 1);
-	}
+	code = r;
+	NumberOfInstructions = code.count(';');
+	if (code.size() != 0 && *code.begin == ';')//a ";" at the very beginning is not counted
+		NumberOfInstructions--;
 }
 
 int basicBlock::numberOfInstructions(){
 	return NumberOfInstructions;
 }
 
-void basicBlock::add_register(string r)
+void basicBlock::set_instructions(int f, int l){
+	first = f;
+	last = l;
+}
+
+int basicBlock::first_instruction(){
+	return first;
+}
+
+int basicBlock::last_instruction(){
+	return last;
+}
+
+void basicBlock::add_register(int r)
 {
 	output_list.insert(r);
 }
 
-void basicBlock::add_predecessor(basicBlock* b)
+void basicBlock::set_pool(objectPool<basicBlock>* p)
 {
-	bool found = false;
-	for (int i = 0; i < predecessors.size(); i++){
-		if (predecessors[i] == b)
-			found = true;
-	}
+	pool = p;
+}
 
-	if (!found)
-		predecessors.push_back(b);
+void basicBlock::add_predecessor(basicBlock* b)
+{
+	pool->append_edge(predecessors_offset, predecessors_length, b->getID());
 }
 
 void basicBlock::add_successor(basicBlock* b)
 {
-	bool found = false;
-	for (int i = 0; i < successors.size(); i++){
-		if (successors[i] == b)
-			found = true;
-	}
-
-	if (!found)
-		successors.push_back(b);
+	pool->append_edge(successors_offset, successors_length, b->getID());
 }
 
 void basicBlock::set_successors(vector<basicBlock*> Set){
-	successors = Set;
+	vector<int32_t> IDs(Set.size());
+	for (int i = 0; i < Set.size(); i++)
+		IDs[i] = Set[i]->getID();
+	successors_offset = pool->store_edges(IDs);
+	successors_length = IDs.size();
+}
+
+void basicBlock::set_successors(neighbourList<basicBlock> Set){
+	vector<int32_t> IDs(Set.size()); //copied first, the list can be a range of the edge array that is growing
+	for (int i = 0; i < Set.size(); i++)
+		IDs[i] = Set[i]->getID();
+	successors_offset = pool->store_edges(IDs);
+	successors_length = IDs.size();
+}
+
+void basicBlock::set_predecessors(vector<basicBlock*> Set){
+	vector<int32_t> IDs(Set.size());
+	for (int i = 0; i < Set.size(); i++)
+		IDs[i] = Set[i]->getID();
+	predecessors_offset = pool->store_edges(IDs);
+	predecessors_length = IDs.size();
 }
 
 void basicBlock::delete_successor(basicBlock* b){
-	vector<basicBlock*>::iterator it;
-	for (it = successors.begin(); it != successors.end(); it++){
-		if(*it == b){
-			successors.erase(it);
-			break;
-		}
+	vector<int32_t> IDs;
+	bool deleted = false;
+	for (int i = 0; i < successors_length; i++){
+		int32_t s = pool->edge(successors_offset + i);
+		if (!deleted && s == b->getID())
+			deleted = true;
+		else
+			IDs.push_back(s);
 	}
+	successors_offset = pool->store_edges(IDs);
+	successors_length = IDs.size();
 }
 
 string basicBlock::get_name()
@@ -216,7 +339,7 @@ int basicBlock::getID(){
 	return ID;
 }
 
-string basicBlock::get_code()
+codeRange basicBlock::get_code()
 {
 	return code;
 }
@@ -226,31 +349,31 @@ int basicBlock::numberOfRegisters()
 	return output_list.size();
 }
 
-set<string> basicBlock::get_output_list()
+registerSet basicBlock::get_output_list()
 {
 	return output_list;
 }
 
-set<string> basicBlock::get_input_list(){
+registerSet basicBlock::get_input_list(){
 	return input_list;
 }
 
-void basicBlock::set_output_list(set<string> s){
+void basicBlock::set_output_list(registerSet s){
 	output_list = s;
 }
 
-void basicBlock::set_input_list(set<string> s){
+void basicBlock::set_input_list(registerSet s){
 	input_list = s;
 }
 
-vector<basicBlock*> basicBlock::get_predecessors()
+neighbourList<basicBlock> basicBlock::get_predecessors()
 {
-	return predecessors;
+	return neighbourList<basicBlock>(pool, predecessors_offset, predecessors_length);
 }
 
-vector<basicBlock*> basicBlock::get_successors()
+neighbourList<basicBlock> basicBlock::get_successors()
 {
-	return successors;
+	return neighbourList<basicBlock>(pool, successors_offset, successors_length);
 }
 
 registerInterval* basicBlock::RegisterInterval(){
@@ -300,3 +423,273 @@ void basicBlock::set_exit_state(){
 bool basicBlock::is_exit_state(){
 	return exit_state;
 }
+
+
+//*******************************************objectPool Methods****************************************
+template<typename T>
+objectPool<T>::objectPool(){
+	count = 0;
+}
+
+template<typename T>
+objectPool<T>::~objectPool(){
+	for (int i = 0; i < count; i++)
+		get(i)->~T();
+	for (int c = 0; c < chunks.size(); c++)
+		::operator delete(chunks[c]);
+}
+
+template<typename T>
+template<typename... Args>
+T* objectPool<T>::create(Args&&... args){
+	if (count == chunks.size() * CHUNK)
+		chunks.push_back(static_cast<T*>(::operator new(sizeof(T) * CHUNK)));
+	T* object = new (chunks[count / CHUNK] + count % CHUNK) T(std::forward<Args>(args)...);
+	count++;
+	return object;
+}
+
+template<typename T>
+T* objectPool<T>::get(int i) const{
+	return chunks[i / CHUNK] + i % CHUNK;
+}
+
+template<typename T>
+int objectPool<T>::size() const{
+	return count;
+}
+
+template<typename T>
+int32_t objectPool<T>::edge(int i) const{
+	return edges[i];
+}
+
+template<typename T>
+int objectPool<T>::store_edges(const vector<int32_t>& IDs){
+	int offset = edges.size();
+	edges.insert(edges.end(), IDs.begin(), IDs.end());
+	return offset;
+}
+
+template<typename T>
+void objectPool<T>::append_edge(int& offset, int& length, int32_t ID){
+	if (offset + length != edges.size())//not the last list, so it is moved to the end (the old range stays as it is)
+		offset = store_edges(vector<int32_t>(edges.begin() + offset, edges.begin() + offset + length));
+	edges.push_back(ID);
+	length++;
+}
+
+template<typename T>
+void objectPool<T>::copy_edges(const objectPool& other){
+	edges = other.edges;
+}
+
+
+//*******************************************csrAdjacency Methods****************************************
+csrAdjacency::csrAdjacency(){
+	offsets.assign(1, 0);
+}
+
+void csrAdjacency::build(int n, const vector<pair<int, int>>& edges){
+	offsets.assign(n + 1, 0);
+	for (int e = 0; e < edges.size(); e++)
+		offsets[edges[e].first + 1]++;
+	for (int x = 0; x < n; x++)
+		offsets[x + 1] += offsets[x];
+
+	targets.resize(edges.size());
+	vector<int> next(offsets.begin(), offsets.end() - 1);
+	for (int e = 0; e < edges.size(); e++)
+		targets[next[edges[e].first]++] = edges[e].second;
+}
+
+const int* csrAdjacency::begin(int x) const{
+	if (x < 0 || x >= nodes())
+		return nullptr;
+	return targets.data() + offsets[x];
+}
+
+const int* csrAdjacency::end(int x) const{
+	if (x < 0 || x >= nodes())
+		return nullptr;
+	return targets.data() + offsets[x + 1];
+}
+
+int csrAdjacency::size(int x) const{
+	if (x < 0 || x >= nodes())
+		return 0;
+	return offsets[x + 1] - offsets[x];
+}
+
+int csrAdjacency::nodes() const{
+	return offsets.size() - 1;
+}
+
+
+//*******************************************epochMarks Methods****************************************
+epochMarks::epochMarks(){
+	epoch = 1; //the stamps start at zero, so no node is marked
+}
+
+void epochMarks::next_epoch(){
+	epoch++;
+	if (epoch == 0){//the stamps of old queries could be equal to the epoch after it wraps around
+		fill(stamps.begin(), stamps.end(), 0u);
+		epoch = 1;
+	}
+}
+
+bool epochMarks::mark(int x){
+	if (x >= (int)stamps.size())
+		stamps.resize(max((size_t)x + 1, 2 * stamps.size()), 0u);
+	if (stamps[x] == epoch)
+		return false;
+	stamps[x] = epoch;
+	return true;
+}
+
+bool epochMarks::marked(int x) const{
+	return x < (int)stamps.size() && stamps[x] == epoch;
+}
+
+
+//*******************************************controlFlowGraph Methods****************************************
+controlFlowGraph::controlFlowGraph(){}
+
+controlFlowGraph::~controlFlowGraph(){}
+
+basicBlock* controlFlowGraph::new_abstract_basicBlock(string name){
+	basicBlock* b = abstract_blocks.create(abstract_blocks.size(), name);
+	b->set_pool(&abstract_blocks);
+	return b;
+}
+
+basicBlock* controlFlowGraph::new_controling_basicBlock(){
+	basicBlock* b = abstract_blocks.create(abstract_blocks.size());
+	b->set_pool(&abstract_blocks);
+	return b;
+}
+
+basicBlock* controlFlowGraph::new_basicBlock(int ABB){
+	basicBlock* b = blocks.create(blocks.size(), ABB);
+	b->set_pool(&blocks);
+	return b;
+}
+
+registerInterval* controlFlowGraph::new_registerInterval(){
+	registerInterval* i = intervals.create(intervals.size());
+	i->set_pool(&intervals);
+	return i;
+}
+
+codeRange controlFlowGraph::keep_text(string text){
+	texts.push_back(text);
+	return codeRange(texts.back().data(), texts.back().data() + texts.back().size());
+}
+
+void controlFlowGraph::decode_instructions(basicBlock* b){
+	int first = instructions.size();
+	int n = instructionDecoder::decode_all(b->get_code(), instructions);
+	b->set_instructions(first, first + n);
+}
+
+void controlFlowGraph::add_instruction(const instruction& I){
+	instructions.push_back(I);
+}
+
+void controlFlowGraph::copy_basicBlocks(const controlFlowGraph& snapshot){
+	for (int i = 0; i < snapshot.abstract_blocks.size(); i++)
+		abstract_blocks.create(*snapshot.abstract_blocks.get(i));
+	for (int i = 0; i < snapshot.blocks.size(); i++)
+		blocks.create(*snapshot.blocks.get(i));
+	instructions = snapshot.instructions;
+
+	//the neighbour lists are IDs, so the copies keep their ranges and the edge arrays are copied as they are
+	//(the neighbours of abstract and controling basicBlocks are abstract basicBlocks and the neighbours of regular basicBlocks are regular ones)
+	abstract_blocks.copy_edges(snapshot.abstract_blocks);
+	blocks.copy_edges(snapshot.blocks);
+	for (int pool = 0; pool < 2; pool++){
+		objectPool<basicBlock>& P = pool == 0 ? abstract_blocks : blocks;
+		for (int i = 0; i < P.size(); i++){
+			auto b = P.get(i);
+			b->set_pool(&P);
+			if (b->get_controling_basicBlock() != nullptr)
+				b->set_control_basicBlock(abstract_blocks.get(b->get_controling_basicBlock()->getID()));
+			b->set_registerInterval(nullptr);
+		}
+	}
+}
+
+int controlFlowGraph::number_of_basicBlocks(){
+	return blocks.size();
+}
+
+int controlFlowGraph::number_of_registerIntervals(){
+	return intervals.size();
+}
+
+basicBlock* controlFlowGraph::basic_block(int ID){
+	return blocks.get(ID);
+}
+
+registerInterval* controlFlowGraph::register_interval(int ID){
+	return intervals.get(ID);
+}
+
+int controlFlowGraph::number_of_instructions(){
+	return instructions.size();
+}
+
+const instruction& controlFlowGraph::get_instruction(int i){
+	return instructions[i];
+}
+void controlFlowGraph::connect(const vector<pair<basicBlock*, basicBlock*>>& edges){
+	int n = 0; //IDs of the basicBlocks are less than n
+	for (int e = 0; e < edges.size(); e++)
+		n = max(n, max(edges[e].first->getID(), edges[e].second->getID()) + 1);
+
+	//the edges of each predecessor (in the given order), so the copies of an edge are found with the marks of its successors
+	vector<pair<int, int>> sources(edges.size()); //(predecessor, edge)
+	for (int e = 0; e < edges.size(); e++)
+		sources[e] = make_pair(edges[e].first->getID(), e);
+	csrAdjacency by_source;
+	by_source.build(n, sources);
+
+	vector<bool> first(edges.size(), false); //is this the first copy of the edge
+	epochMarks successors;
+	for (int x = 0; x < n; x++){
+		successors.next_epoch();
+		for (auto e = by_source.begin(x); e != by_source.end(x); e++)
+			first[*e] = successors.mark(edges[*e].second->getID());
+	}
+
+	//the first copies are grouped by successor too, and each neighbour list is written once (after the neighbours the basicBlock already has)
+	vector<pair<int, int>> targets; //(successor, edge)
+	for (int e = 0; e < edges.size(); e++)
+		if (first[e])
+			targets.push_back(make_pair(edges[e].second->getID(), e));
+	csrAdjacency by_target;
+	by_target.build(n, targets);
+
+	for (int x = 0; x < n; x++){
+		if (by_source.size(x) != 0){
+			basicBlock* b = edges[*by_source.begin(x)].first;
+			vector<basicBlock*> S;
+			for (auto s : b->get_successors())
+				S.push_back(s);
+			for (auto e = by_source.begin(x); e != by_source.end(x); e++)
+				if (first[*e])
+					S.push_back(edges[*e].second);
+			b->set_successors(S);
+		}
+		if (by_target.size(x) != 0){
+			basicBlock* b = edges[*by_target.begin(x)].second;
+			vector<basicBlock*> P;
+			for (auto p : b->get_predecessors())
+				P.push_back(p);
+			for (auto e = by_target.begin(x); e != by_target.end(x); e++)
+				P.push_back(edges[*e].first);
+			b->set_predecessors(P);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,242 @@
+/*
+ * \file    DominatorTree.cpp
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Implementation of the dominator tree of the basic block CFG
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#include <algorithm>
+#include <utility>
+
+#include "../interface/DominatorTree.h"
+
+using namespace std;
+
+dominatorTree::dominatorTree(){
+	components = 0;
+}
+
+void dominatorTree::resize(int n){
+	if (n <= (int)block.size())
+		return;
+	block.resize(n, nullptr);
+	idom.resize(n, -1);
+	preorder.resize(n, -1);
+	last.resize(n, -1);
+	component.resize(n, -1);
+	leaf.resize(n, false);
+}
+
+void dominatorTree::build(vector<basicBlock*> blocks){
+	block.clear();
+	idom.clear();
+	preorder.clear();
+	last.clear();
+	component.clear();
+	leaf.clear();
+	components = 0;
+
+	int n = 0;
+	for (auto b = blocks.begin(); b != blocks.end(); b++)
+		n = max(n, (*b)->getID() + 1);
+	resize(n);
+	for (auto b = blocks.begin(); b != blocks.end(); b++)
+		block[(*b)->getID()] = *b;
+
+	/* successors of CFG are derived from the predecessor lists; slot n is the virtual root*/
+	int root = n;
+	vector<pair<int, int>> edges; //(predecessor, basic block)
+	for (auto b = blocks.begin(); b != blocks.end(); b++){
+		int x = (*b)->getID();
+		auto P = (*b)->get_predecessors();
+		if (P.size() == 0)
+			edges.push_back(make_pair(root, x));
+		for (auto p = P.begin(); p != P.end(); p++)
+			edges.push_back(make_pair((*p)->getID(), x));
+	}
+	csrAdjacency successors, predecessors;
+	successors.build(n + 1, edges);
+	for (int e = 0; e < edges.size(); e++)
+		swap(edges[e].first, edges[e].second);
+	predecessors.build(n + 1, edges);
+
+	//************************Reverse postorder from the virtual root*************************
+	vector<int> postorder_number(n + 1, -1);
+	vector<int> postorder;
+	{
+		vector<bool> visited(n + 1, false);
+		vector<pair<int, int>> stack; //(node, next successor)
+		stack.push_back(make_pair(root, 0));
+		visited[root] = true;
+		while (!stack.empty()){
+			int x = stack.back().first;
+			int& next = stack.back().second;
+			if (next < successors.size(x)){
+				int s = successors.begin(x)[next++];
+				if (!visited[s]){
+					visited[s] = true;
+					stack.push_back(make_pair(s, 0));
+				}
+			}
+			else{
+				postorder_number[x] = postorder.size();
+				postorder.push_back(x);
+				stack.pop_back();
+			}
+		}
+	}
+
+	//************************Immediate dominators (Cooper, Harvey and Kennedy)*************************
+	vector<int> dom(n + 1, -1);
+	dom[root] = root;
+	bool changed = true;
+	while (changed){
+		changed = false;
+		for (int k = (int)postorder.size() - 2; k >= 0; k--){//reverse postorder without the root
+			int x = postorder[k];
+			int new_idom = -1;
+			for (auto p = predecessors.begin(x); p != predecessors.end(x); p++){
+				if (dom[*p] == -1)
+					continue;
+				if (new_idom == -1){
+					new_idom = *p;
+					continue;
+				}
+				int a = *p, b = new_idom;
+				while (a != b){
+					while (postorder_number[a] < postorder_number[b])
+						a = dom[a];
+					while (postorder_number[b] < postorder_number[a])
+						b = dom[b];
+				}
+				new_idom = a;
+			}
+			if (dom[x] != new_idom){
+				dom[x] = new_idom;
+				changed = true;
+			}
+		}
+	}
+
+	//************************Preorder numbering of the dominator tree*************************
+	vector<vector<int>> children(n + 1);
+	for (int k = (int)postorder.size() - 2; k >= 0; k--){
+		int x = postorder[k];
+		children[dom[x]].push_back(x);
+		idom[x] = (dom[x] == root) ? -1 : dom[x];
+	}
+	{
+		int counter = 0;
+		vector<pair<int, int>> stack;
+		stack.push_back(make_pair(root, 0));
+		while (!stack.empty()){
+			int x = stack.back().first;
+			int& next = stack.back().second;
+			if (next == 0 && x != root)
+				preorder[x] = counter++;
+			if (next < (int)children[x].size()){
+				int c = children[x][next++];
+				stack.push_back(make_pair(c, 0));
+			}
+			else{
+				if (x != root)
+					last[x] = counter - 1;
+				stack.pop_back();
+			}
+		}
+	}
+
+	//************************Strongly connected components (Tarjan)*************************
+	{
+		vector<int> index(n, -1), low(n, 0);
+		vector<bool> on_stack(n, false);
+		vector<int> scc_stack;
+		vector<pair<int, int>> stack;
+		int counter = 0;
+		for (auto b = blocks.begin(); b != blocks.end(); b++){
+			int start = (*b)->getID();
+			if (index[start] != -1)
+				continue;
+			stack.push_back(make_pair(start, 0));
+			while (!stack.empty()){
+				int x = stack.back().first;
+				int& next = stack.back().second;
+				if (next == 0){
+					index[x] = low[x] = counter++;
+					scc_stack.push_back(x);
+					on_stack[x] = true;
+				}
+				if (next < successors.size(x)){
+					int s = successors.begin(x)[next++];
+					if (index[s] == -1)
+						stack.push_back(make_pair(s, 0));
+					else if (on_stack[s])
+						low[x] = min(low[x], index[s]);
+					continue;
+				}
+				if (low[x] == index[x]){
+					int y;
+					do{
+						y = scc_stack.back();
+						scc_stack.pop_back();
+						on_stack[y] = false;
+						component[y] = components;
+					} while (y != x);
+					components++;
+				}
+				stack.pop_back();
+				if (!stack.empty()){
+					int parent = stack.back().first;
+					low[parent] = min(low[parent], low[x]);
+				}
+			}
+		}
+	}
+}
+
+void dominatorTree::add_leaf(basicBlock* b, basicBlock* parent){
+	int x = b->getID();
+	resize(x + 1);
+	block[x] = b;
+	idom[x] = parent->getID();
+	preorder[x] = -1;
+	last[x] = -1;
+	component[x] = components++;
+	leaf[x] = true;
+}
+
+bool dominatorTree::dominates(basicBlock* a, basicBlock* b){
+	int y = a->getID();
+	int x = b->getID();
+	if (x >= (int)block.size() || y >= (int)block.size())
+		return false;
+
+	while (leaf[x]){//a leaf is dominated by its parent and everything that dominates its parent
+		if (x == y)
+			return true;
+		x = idom[x];
+	}
+	if (leaf[y] || preorder[x] < 0 || preorder[y] < 0)
+		return false;
+	return preorder[y] <= preorder[x] && preorder[x] <= last[y];
+}
+
+basicBlock* dominatorTree::immediate_dominator(basicBlock* b){
+	int x = b->getID();
+	if (x >= (int)block.size() || idom[x] < 0)
+		return nullptr;
+	return block[idom[x]];
+}
+
+bool dominatorTree::same_component(basicBlock* a, basicBlock* b){
+	int x = a->getID();
+	int y = b->getID();
+	if (x >= (int)block.size() || y >= (int)block.size())
+		return false;
+	return component[x] == component[y];
+}
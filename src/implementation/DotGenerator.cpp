@@ -0,0 +1,167 @@
+/*
+ * \file    DotGenerator.cpp
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Implementation of the generator of synthetic CFGs
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../interface/DotGenerator.h"
+
+using namespace std;
+
+generatorOptions::generatorOptions(){
+	blocks = 1000;
+	kernels = 1;
+	loop_depth = 3;
+	branch_density = 0.3;
+	min_instructions = 2;
+	max_instructions = 12;
+	registers = 64;
+	seed = 1;
+}
+
+namespace {
+
+/* \brief The random choices of the generator*/
+class generatorRandom
+{
+public:
+	generatorRandom(unsigned seed) : engine(seed) {}
+
+        /* Get a number of [a, b]*/
+	int uniform(int a, int b){
+		return a + (int)(engine() % (unsigned)(b - a + 1));
+	}
+        /* Get true with probability p*/
+	bool chance(double p){
+		return engine() < p * 4294967296.0;
+	}
+
+private:
+	mt19937 engine;
+};
+
+/* \brief Appends a random instruction in the escaped format of nvdisasm record labels (e.g. "\ \ IADD\ R2,\ R3,\ R4;\l")*/
+void append_instruction(string& label, generatorRandom& random, int registers){
+	auto R = [&random, registers](){ return "R" + to_string(random.uniform(0, registers - 1)); };
+	label += "\\ \\ ";
+	switch (random.uniform(0, 9)){
+	case 0:
+		label += "LD.E\\ " + R() + ",\\ \\[" + R() + "\\]";
+		break;
+	case 1:
+		label += "ST.E\\ \\[" + R() + "\\],\\ " + R();
+		break;
+	case 2:
+		label += "MOV\\ " + R() + ",\\ c\\[0x0\\]\\[0x" + to_string(140 + 4 * random.uniform(0, 15)) + "\\]";
+		break;
+	case 3:
+		label += "IMAD\\ " + R() + ",\\ " + R() + ",\\ " + R() + ",\\ " + R();
+		break;
+	case 4:
+		label += "FFMA\\ " + R() + ",\\ " + R() + ",\\ " + R() + ",\\ " + R();
+		break;
+	case 5:
+		label += "SHL\\ " + R() + ",\\ " + R() + ",\\ 0x2";
+		break;
+	case 6:
+		label += "FADD\\ " + R() + ",\\ " + R() + ",\\ " + R();
+		break;
+	default:
+		label += "IADD\\ " + R() + ",\\ " + R() + ",\\ " + R();
+		break;
+	}
+	label += ";\\l";
+}
+
+/* \brief The name of a block: the first block of a kernel is named after the kernel and the others are numbered labels
+          (the numbers have the same number of digits, so the labels of a generated file sort in the order of the blocks)*/
+string block_name(int kernel, int b, int blocks, int kernels){
+	if (b == 0)
+		return "_Z9syntheticv_" + to_string(kernel);
+	string number = to_string((long long)kernel * (blocks + 1) + b);
+	return ".L_" + string(to_string((long long)kernels * (blocks + 1)).size() - number.size(), '0') + number;
+}
+
+void append_edge(string& edges, const string& source, const char* port, const string& target){
+	edges += "\"" + source + "\":" + port + " -> \"" + target + "\":entry:n [style=solid];\n";
+}
+
+}
+
+long long DotGenerator::generate(const generatorOptions& options, resultWriter& out){
+	generatorRandom random(options.seed);
+	int blocks = max(options.blocks, 1);
+	int registers = min(max(options.registers, 1), (int)registerSet::MAX_REGISTERS);
+	int min_instructions = max(options.min_instructions, 0);
+	int max_instructions = max(options.max_instructions, min_instructions);
+	long long edges_count = 0;
+
+	out << "digraph f {\n";
+	int kernels = max(options.kernels, 1);
+	for (int k = 0; k < kernels; k++){
+		out << "subgraph \"cluster_" << block_name(k, 0, blocks, kernels) << "\" {\n";
+
+		vector<pair<int, int>> loops; //(head, tail) of the open loops, the innermost last
+		string label, edges;
+		for (int b = 0; b < blocks; b++){
+			//a loop starts at this block with a body that ends before the end of the enclosing loop, but not at the first block:
+			//the entry of a kernel has no predecessors (the chance is drawn before b is tested, so the RNG stream does not depend on this condition)
+			int limit = loops.empty() ? blocks - 2 : loops.back().second - 1;
+			if (loops.size() < options.loop_depth && b < limit && random.chance(0.15) && b > 0){
+				int length = random.uniform(1, max(1, min(limit - b, 256 >> loops.size())));
+				loops.push_back(make_pair(b, b + length));
+			}
+
+			string name = block_name(k, b, blocks, kernels);
+			string next = block_name(k, b + 1, blocks, kernels);
+			label = "<entry>" + name + ":\\l";
+			edges.clear();
+			for (int i = random.uniform(min_instructions, max_instructions); i > 0; i--)
+				append_instruction(label, random, registers);
+
+			int target = -1; //the target of the conditional branch at the end of the block
+			if (!loops.empty() && loops.back().second == b){//the end of a loop branches back to its head
+				target = loops.back().first;
+				loops.pop_back();
+			}
+			else if (b < blocks - 1 && random.chance(options.branch_density)){//forward branch inside the innermost loop
+				int end = loops.empty() ? blocks - 1 : loops.back().second;
+				if (end > b + 1)
+					target = random.uniform(b + 2, min(end, b + 64));
+			}
+
+			if (b == blocks - 1)
+				label += "|<exit0>\\ \\ EXIT;\\l";
+			else if (target >= 0){
+				label += "\\ \\ ISETP.GE.AND\\ P0,\\ PT,\\ R" + to_string(random.uniform(0, registers - 1)) + ",\\ R"
+				         + to_string(random.uniform(0, registers - 1)) + ",\\ PT;\\l";
+				label += "|<exit0>\\ \\ @P0\\ BRA\\ `(" + block_name(k, target, blocks, kernels) + ");\\l";
+				//as in nvdisasm, the branch leaves the east side of the exit field and the fall-through its south side
+				append_edge(edges, name, "exit0:e", block_name(k, target, blocks, kernels));
+				append_edge(edges, name, "exit0:s", next);
+				edges_count += 2;
+			}
+			else{
+				append_edge(edges, name, "entry:s", next);
+				edges_count++;
+			}
+
+			out << "node [fontname=\"Courier\",fontsize=10,shape=Mrecord];\n\"" << name << "\"\n[label=\"{" << label << "}\"]\n" << edges;
+		}
+
+		out << "}\n";
+	}
+	out << "}\n";
+	return edges_count;
+}
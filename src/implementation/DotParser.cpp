@@ -0,0 +1,376 @@
+/*
+ * \file    DotParser.cpp
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Implementation of the Graphviz Dot parser
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../interface/DotParser.h"
+
+using namespace std;
+
+//******************************************mappedFile Methods**************************************
+mappedFile::mappedFile(){
+	buffer = nullptr;
+	length = 0;
+	mapped = false;
+}
+
+mappedFile::~mappedFile(){
+	close();
+}
+
+bool mappedFile::open(const char* file_name){
+	close();
+
+	int fd = ::open(file_name, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0){
+		void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p != MAP_FAILED){
+			madvise(p, st.st_size, MADV_SEQUENTIAL);
+			buffer = static_cast<const char*>(p);
+			length = st.st_size;
+			mapped = true;
+		}
+	}
+	::close(fd);
+
+	if (!mapped){//pipes, empty files and file systems without mmap support are read in one go
+		ifstream in(file_name, ios::in | ios::binary);
+		if (!in)
+			return false;
+		stringstream ss;
+		ss << in.rdbuf();
+		fallback = ss.str();
+		buffer = fallback.data();
+		length = fallback.size();
+	}
+	return true;
+}
+
+void mappedFile::close(){
+	if (mapped)
+		munmap(const_cast<char*>(buffer), length);
+	buffer = nullptr;
+	length = 0;
+	mapped = false;
+	fallback.clear();
+}
+
+const char* mappedFile::data() const{
+	return buffer;
+}
+
+size_t mappedFile::size() const{
+	return length;
+}
+
+string mappedFile::text(textSpan s) const{
+	return string(buffer + s.offset, s.length);
+}
+
+//******************************************Tokenizer**************************************
+namespace {
+
+enum tokenKind { TOKEN_END, TOKEN_ID, TOKEN_QUOTED, TOKEN_ARROW, TOKEN_PUNCT };
+
+struct token
+{
+	tokenKind kind;
+	textSpan span; //for quoted strings the span excludes the quotes
+	char punct;
+};
+
+/* \brief Splits the Dot code into identifiers, quoted strings, "->" and single character punctuation*/
+class dotLexer
+{
+public:
+	dotLexer(const char* d, size_t n) : data(d), size(n), pos(0) {}
+
+	token next(){
+		token t;
+		t.punct = 0;
+		skip_blanks();
+		t.span.offset = pos;
+		t.span.length = 0;
+		if (pos >= size){
+			t.kind = TOKEN_END;
+			return t;
+		}
+
+		char c = data[pos];
+		if (c == '"'){
+			size_t begin = ++pos;
+			while (pos < size && data[pos] != '"'){
+				if (data[pos] == '\\' && pos + 1 < size)//escaped characters (e.g. \" in NOP.S targets) do not close the string
+					pos++;
+				pos++;
+			}
+			t.kind = TOKEN_QUOTED;
+			t.span.offset = begin;
+			t.span.length = pos - begin;
+			if (pos < size)
+				pos++;
+			return t;
+		}
+
+		if (c == '-' && pos + 1 < size && data[pos + 1] == '>'){
+			pos += 2;
+			t.kind = TOKEN_ARROW;
+			t.span.length = 2;
+			return t;
+		}
+
+		if (is_id_char(c)){
+			while (pos < size && is_id_char(data[pos]))
+				pos++;
+			t.kind = TOKEN_ID;
+			t.span.length = pos - t.span.offset;
+			return t;
+		}
+
+		pos++;
+		t.kind = TOKEN_PUNCT;
+		t.punct = c;
+		t.span.length = 1;
+		return t;
+	}
+
+private:
+	static bool is_id_char(char c){
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+			|| c == '_' || c == '.' || c == '$' || (c & 0x80);
+	}
+
+	void skip_blanks(){
+		while (pos < size){
+			char c = data[pos];
+			if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+				pos++;
+			else if (c == '/' && pos + 1 < size && data[pos + 1] == '/'){
+				while (pos < size && data[pos] != '\n')
+					pos++;
+			}
+			else if (c == '/' && pos + 1 < size && data[pos + 1] == '*'){
+				pos += 2;
+				while (pos + 1 < size && !(data[pos] == '*' && data[pos + 1] == '/'))
+					pos++;
+				pos += 2;
+			}
+			else
+				break;
+		}
+	}
+
+	const char* data;
+	size_t size;
+	size_t pos;
+};
+
+bool is_punct(const token& t, char c){
+	return t.kind == TOKEN_PUNCT && t.punct == c;
+}
+
+bool is_id(const token& t){
+	return t.kind == TOKEN_ID || t.kind == TOKEN_QUOTED;
+}
+
+bool span_equals(const char* data, textSpan s, const char* word){
+	size_t n = strlen(word);
+	return s.length == n && memcmp(data + s.offset, word, n) == 0;
+}
+
+bool span_starts_with(const char* data, textSpan s, const char* word){
+	size_t n = strlen(word);
+	return s.length >= n && memcmp(data + s.offset, word, n) == 0;
+}
+
+/* \brief Consumes an attribute list "[a=b, c=d]" and returns the span of its label (if any)*/
+token skip_attributes(dotLexer& lex, token t, const char* data, textSpan* label){
+	while (is_punct(t, '[')){
+		t = lex.next();
+		while (t.kind != TOKEN_END && !is_punct(t, ']')){
+			if (is_id(t)){
+				token key = t;
+				t = lex.next();
+				if (is_punct(t, '=')){
+					t = lex.next();
+					if (label != nullptr && key.kind == TOKEN_ID && span_equals(data, key.span, "label"))
+						*label = t.span;
+				}
+				continue;
+			}
+			t = lex.next();
+		}
+		if (t.kind != TOKEN_END)
+			t = lex.next();
+	}
+	return t;
+}
+
+/* \brief Consumes an optional ":port:compass" suffix of a node id*/
+token read_port(dotLexer& lex, token t, textSpan* port, textSpan* compass){
+	port->offset = compass->offset = 0;
+	port->length = compass->length = 0;
+	if (is_punct(t, ':')){
+		t = lex.next();
+		*port = t.span;
+		t = lex.next();
+		if (is_punct(t, ':')){
+			t = lex.next();
+			*compass = t.span;
+			t = lex.next();
+		}
+	}
+	return t;
+}
+
+/* \brief The instructions of a node are stored in a record label "{<entry>...\l}"*/
+textSpan label_code(const char* data, textSpan label){
+	textSpan code = label;
+	if (code.length >= 2 && data[code.offset] == '{' && data[code.offset + code.length - 1] == '}'){
+		code.offset++;
+		code.length -= 2;
+	}
+	if (code.length >= 2 && data[code.offset + code.length - 2] == '\\' && data[code.offset + code.length - 1] == 'l')
+		code.length -= 2;
+	return code;
+}
+
+}
+
+//******************************************DotParser Methods**************************************
+bool DotParser::parse(const mappedFile& file, vector<dotNode>& nodes, vector<dotEdge>& edges){
+	vector<textSpan> clusters;
+	return parse(file, nodes, edges, clusters);
+}
+
+bool DotParser::parse(const mappedFile& file, vector<dotNode>& nodes, vector<dotEdge>& edges, vector<textSpan>& clusters){
+	const char* data = file.data();
+	dotLexer lex(data, file.size());
+
+	nodes.clear();
+	edges.clear();
+	clusters.clear();
+	vector<pair<int, int>> open_clusters; //(depth of the body, cluster) of the clusters that contain the current statement
+
+	token t = lex.next();
+	if (t.kind == TOKEN_ID && span_equals(data, t.span, "strict"))
+		t = lex.next();
+	if (!(t.kind == TOKEN_ID && (span_equals(data, t.span, "digraph") || span_equals(data, t.span, "graph"))))
+		return false;
+	t = lex.next();
+	if (is_id(t))
+		t = lex.next();
+	if (!is_punct(t, '{'))
+		return false;
+	t = lex.next();
+
+	int depth = 1;
+	while (t.kind != TOKEN_END && depth > 0){
+		int cluster = open_clusters.empty() ? -1 : open_clusters.back().second;
+		if (is_punct(t, '}')){
+			if (!open_clusters.empty() && open_clusters.back().first == depth)
+				open_clusters.pop_back();
+			depth--;
+			t = lex.next();
+			continue;
+		}
+		if (is_punct(t, '{')){//anonymous subgraph
+			depth++;
+			t = lex.next();
+			continue;
+		}
+		if (!is_id(t)){//';' and other separators
+			t = lex.next();
+			continue;
+		}
+
+		if (t.kind == TOKEN_ID && span_equals(data, t.span, "subgraph")){
+			t = lex.next();
+			bool is_cluster = false;
+			if (is_id(t)){
+				if (span_starts_with(data, t.span, "cluster")){
+					is_cluster = true;
+					clusters.push_back(t.span);
+				}
+				t = lex.next();
+			}
+			if (is_punct(t, '{')){
+				depth++;
+				if (is_cluster)
+					open_clusters.push_back(make_pair(depth, (int)clusters.size() - 1));
+				t = lex.next();
+			}
+			continue;
+		}
+
+		if (t.kind == TOKEN_ID && (span_equals(data, t.span, "node") || span_equals(data, t.span, "edge") || span_equals(data, t.span, "graph"))){
+			t = skip_attributes(lex, lex.next(), data, nullptr);
+			continue;
+		}
+
+		token id = t;
+		textSpan port, compass;
+		t = read_port(lex, lex.next(), &port, &compass);
+
+		if (is_punct(t, '=')){//graph attribute (e.g. rankdir=TB)
+			lex.next();
+			t = lex.next();
+			continue;
+		}
+
+		if (t.kind == TOKEN_ARROW){
+			while (t.kind == TOKEN_ARROW){
+				token target = lex.next();
+				textSpan target_port, target_compass;
+				t = read_port(lex, lex.next(), &target_port, &target_compass);
+
+				dotEdge e;
+				e.source = id.span;
+				e.target = target.span;
+				e.fallthrough = span_equals(data, port, "entry") && span_equals(data, compass, "s");
+				e.cluster = cluster;
+				if (e.fallthrough || span_starts_with(data, port, "exit"))//other ports do not carry control flow
+					edges.push_back(e);
+
+				id = target;
+				port = target_port;
+				compass = target_compass;
+			}
+			t = skip_attributes(lex, t, data, nullptr);
+			continue;
+		}
+
+		dotNode n;
+		textSpan label;
+		label.offset = id.span.offset;
+		label.length = 0;
+		t = skip_attributes(lex, t, data, &label);
+		n.name = id.span;
+		n.code = label_code(data, label);
+		n.cluster = cluster;
+		nodes.push_back(n);
+	}
+
+	return depth == 0;
+}
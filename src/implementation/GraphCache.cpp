@@ -0,0 +1,355 @@
+/*
+ * \file    GraphCache.cpp
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Implementation of the binary cache of control flow graphs
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <unistd.h>
+
+#include "../interface/GraphCache.h"
+
+using namespace std;
+
+static_assert(sizeof(cacheHeader) == 40 && sizeof(cacheSpan) == 16 && sizeof(cacheKernel) == 32 && sizeof(cacheSection) == 16,
+              "the records of the cache file should have no padding");
+static_assert(sizeof(cacheBlock) % 8 == 0 && sizeof(cacheInstruction) % 8 == 0, "the records of the cache file should be 8-byte aligned");
+
+namespace {
+
+const char CACHE_MAGIC[8] = {'R', 'I', 'C', 'F', 'G', 0, 0, 0};
+
+size_t padded(size_t n){
+	return (n + 7) & ~(size_t)7;
+}
+
+template<typename T>
+void append(string& out, const T& record){
+	out.append(reinterpret_cast<const char*>(&record), sizeof(T));
+}
+
+void pad(string& out){
+	out.append(padded(out.size()) - out.size(), '\0');
+}
+
+/* \brief A range of text is cached as a span of the input (it should be in the input)*/
+bool input_span(codeRange r, const mappedFile& input, cacheSpan& span){
+	if (r.size() == 0){
+		span.offset = span.length = 0;
+		return true;
+	}
+	if (r.begin < input.data() || r.end > input.data() + input.size())
+		return false;
+	span.offset = r.begin - input.data();
+	span.length = r.size();
+	return true;
+}
+
+bool valid_span(const cacheSpan& s, size_t input_size){
+	return s.offset <= input_size && s.length <= input_size - s.offset;
+}
+
+codeRange input_range(const cacheSpan& s, const mappedFile& input){
+	return codeRange(input.data() + s.offset, input.data() + s.offset + s.length);
+}
+
+}
+
+//******************************************graphCache Methods**************************************
+graphCache::graphCache(){
+	header = nullptr;
+	cluster_spans = nullptr;
+	kernels = nullptr;
+}
+
+bool graphCache::open(const string& path, uint64_t hash, size_t input_size){
+	close();
+	if (access(path.c_str(), R_OK) != 0 || !file.open(path.c_str()))
+		return false;
+
+	const char* data = file.data();
+	size_t size = file.size();
+	if (size < sizeof(cacheHeader)){
+		close();
+		return false;
+	}
+	header = reinterpret_cast<const cacheHeader*>(data);
+	size_t tables = sizeof(cacheHeader) + (size_t)header->clusters * sizeof(cacheSpan) + (size_t)header->kernels * sizeof(cacheKernel);
+	if (memcmp(header->magic, CACHE_MAGIC, 8) != 0 || header->version != VERSION || header->registers != registerSet::MAX_REGISTERS
+		|| header->hash != hash || header->input_size != input_size || tables > size){
+		close();
+		return false;
+	}
+	cluster_spans = reinterpret_cast<const cacheSpan*>(data + sizeof(cacheHeader));
+	kernels = reinterpret_cast<const cacheKernel*>(cluster_spans + header->clusters);
+
+	//everything is checked once here, so a damaged cache file is ignored instead of creating a damaged CFG
+	bool valid = true;
+	for (int c = 0; c < header->clusters; c++)
+		valid = valid && valid_span(cluster_spans[c], input_size);
+	for (int k = 0; k < header->kernels; k++)
+		valid = valid && kernels[k].cluster >= -1 && kernels[k].cluster < (int)header->clusters && valid_section(kernels[k], input_size);
+	if (!valid){
+		close();
+		return false;
+	}
+	return true;
+}
+
+bool graphCache::valid_section(const cacheKernel& K, size_t input_size) const{
+	size_t size = file.size();
+	if (K.section % 8 != 0 || K.section > size || K.section_length > size - K.section || K.section_length < sizeof(cacheSection))
+		return false;
+
+	const char* data = file.data() + K.section;
+	const cacheSection* S = reinterpret_cast<const cacheSection*>(data);
+	size_t length = sizeof(cacheSection) + (size_t)S->blocks * sizeof(cacheBlock) + (size_t)S->instructions * sizeof(cacheInstruction)
+	                + padded((size_t)S->adjacency * sizeof(int32_t)) + padded(S->names);
+	if (length != K.section_length)
+		return false;
+
+	const cacheBlock* blocks = reinterpret_cast<const cacheBlock*>(S + 1);
+	const cacheInstruction* instructions = reinterpret_cast<const cacheInstruction*>(blocks + S->blocks);
+	const int32_t* adjacency = reinterpret_cast<const int32_t*>(instructions + S->instructions);
+
+	size_t edges = 0;
+	for (int b = 0; b < S->blocks; b++){
+		const cacheBlock& B = blocks[b];
+		if (B.first < 0 || B.first > B.last || B.last > (int)S->instructions || B.predecessors < 0 || B.successors < 0
+			|| B.name_offset > S->names || B.name_length > S->names - B.name_offset || !valid_span(B.code, input_size))
+			return false;
+		edges += (size_t)B.predecessors + B.successors;
+	}
+	if (edges != S->adjacency)
+		return false;
+	for (size_t e = 0; e < edges; e++)
+		if (adjacency[e] < 0 || adjacency[e] >= (int)S->blocks)
+			return false;
+	for (int i = 0; i < S->instructions; i++)
+		if (!valid_span(instructions[i].text, input_size) || !valid_span(instructions[i].opcode, input_size))
+			return false;
+	return true;
+}
+
+void graphCache::close(){
+	file.close();
+	header = nullptr;
+	cluster_spans = nullptr;
+	kernels = nullptr;
+}
+
+int graphCache::number_of_kernels() const{
+	return header == nullptr ? 0 : header->kernels;
+}
+
+int graphCache::kernel_cluster(int k) const{
+	return kernels[k].cluster;
+}
+
+size_t graphCache::kernel_size(int k) const{
+	return kernels[k].size;
+}
+
+vector<textSpan> graphCache::clusters() const{
+	vector<textSpan> spans;
+	for (int c = 0; header != nullptr && c < header->clusters; c++){
+		textSpan s;
+		s.offset = cluster_spans[c].offset;
+		s.length = cluster_spans[c].length;
+		spans.push_back(s);
+	}
+	return spans;
+}
+
+vector<basicBlock*> graphCache::load_kernel(int k, const mappedFile& input, controlFlowGraph& graph) const{
+	const cacheSection* S = reinterpret_cast<const cacheSection*>(file.data() + kernels[k].section);
+	const cacheBlock* blocks = reinterpret_cast<const cacheBlock*>(S + 1);
+	const cacheInstruction* instructions = reinterpret_cast<const cacheInstruction*>(blocks + S->blocks);
+	const int32_t* adjacency = reinterpret_cast<const int32_t*>(instructions + S->instructions);
+	const char* names = reinterpret_cast<const char*>(adjacency) + padded((size_t)S->adjacency * sizeof(int32_t));
+
+	int base = graph.number_of_instructions(); //the instructions of the section are appended to the instruction stream
+	for (int i = 0; i < S->instructions; i++){
+		instruction I;
+		I.text = input_range(instructions[i].text, input);
+		I.opcode = input_range(instructions[i].opcode, input);
+		I.guard = instructions[i].guard;
+		I.negated_guard = instructions[i].negated_guard != 0;
+		I.defs = instructions[i].defs;
+		I.uses = instructions[i].uses;
+		graph.add_instruction(I);
+	}
+
+	vector<basicBlock*> basic_blocks;
+	for (int b = 0; b < S->blocks; b++){
+		auto B = graph.new_basicBlock(blocks[b].ABB);
+		B->set_name(string(names + blocks[b].name_offset, blocks[b].name_length));
+		B->set_code(input_range(blocks[b].code, input));
+		B->set_instructions(base + blocks[b].first, base + blocks[b].last);
+		B->set_output_list(blocks[b].registers);
+		basic_blocks.push_back(B);
+	}
+
+	const int32_t* e = adjacency;
+	for (int b = 0; b < S->blocks; b++){
+		vector<basicBlock*> neighbours;
+		for (int j = 0; j < blocks[b].predecessors; j++)
+			neighbours.push_back(basic_blocks[*e++]);
+		basic_blocks[b]->set_predecessors(neighbours);
+		neighbours.clear();
+		for (int j = 0; j < blocks[b].successors; j++)
+			neighbours.push_back(basic_blocks[*e++]);
+		basic_blocks[b]->set_successors(neighbours);
+	}
+	return basic_blocks;
+}
+
+uint64_t graphCache::content_hash(const char* data, size_t size){
+	uint64_t h = 0x9E3779B97F4A7C15ULL ^ size;
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8){
+		uint64_t w;
+		memcpy(&w, data + i, 8);
+		h = (h ^ w) * 0xFF51AFD7ED558CCDULL;
+		h ^= h >> 32;
+	}
+	uint64_t w = 0;
+	memcpy(&w, data + i, size - i);
+	h = (h ^ w) * 0xFF51AFD7ED558CCDULL;
+
+	//the final mixing of splitmix64
+	h ^= h >> 30;
+	h *= 0xBF58476D1CE4E5B9ULL;
+	h ^= h >> 27;
+	h *= 0x94D049BB133111EBULL;
+	h ^= h >> 31;
+	return h;
+}
+
+string graphCache::file_name(const string& directory, uint64_t hash){
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.ricfg", (unsigned long long)hash);
+	return directory + "/" + name;
+}
+
+bool graphCache::save_kernel(controlFlowGraph& graph, const vector<basicBlock*>& blocks, const mappedFile& input, string& section){
+	section.clear();
+	if (blocks.size() == 0){
+		cacheSection S = {0, 0, 0, 0};
+		append(section, S);
+		return true;
+	}
+
+	//the instructions of the kernel are contiguous in the instruction stream and the blocks are in the order of their IDs
+	int first = blocks.front()->first_instruction();
+	int last = blocks.back()->last_instruction();
+	vector<int32_t> adjacency;
+	string names;
+	string records;
+	for (int b = 0; b < blocks.size(); b++){
+		if (blocks[b]->getID() != blocks.front()->getID() + b)
+			return false;
+		cacheBlock B;
+		B.ABB = blocks[b]->get_ABB();
+		B.first = blocks[b]->first_instruction() - first;
+		B.last = blocks[b]->last_instruction() - first;
+		auto P = blocks[b]->get_predecessors();
+		auto Q = blocks[b]->get_successors();
+		B.predecessors = P.size();
+		B.successors = Q.size();
+		for (int j = 0; j < P.size(); j++)
+			adjacency.push_back(P[j]->getID() - blocks.front()->getID());
+		for (int j = 0; j < Q.size(); j++)
+			adjacency.push_back(Q[j]->getID() - blocks.front()->getID());
+		string name = blocks[b]->get_name();
+		B.name_offset = names.size();
+		B.name_length = name.size();
+		names += name;
+		B.reserved = 0;
+		B.registers = blocks[b]->get_output_list();
+		if (!input_span(blocks[b]->get_code(), input, B.code))
+			return false;
+		append(records, B);
+	}
+
+	for (int i = first; i < last; i++){
+		const instruction& I = graph.get_instruction(i);
+		cacheInstruction R;
+		if (!input_span(I.text, input, R.text) || !input_span(I.opcode, input, R.opcode))
+			return false;
+		R.guard = I.guard;
+		R.negated_guard = I.negated_guard;
+		R.defs = I.defs;
+		R.uses = I.uses;
+		append(records, R);
+	}
+
+	cacheSection S;
+	S.blocks = blocks.size();
+	S.instructions = last - first;
+	S.adjacency = adjacency.size();
+	S.names = names.size();
+	append(section, S);
+	section += records;
+	section.append(reinterpret_cast<const char*>(adjacency.data()), adjacency.size() * sizeof(int32_t));
+	pad(section);
+	section += names;
+	pad(section);
+	return true;
+}
+
+bool graphCache::write(const string& path, uint64_t hash, size_t input_size, const vector<textSpan>& clusters,
+                       const vector<int>& kernel_clusters, const vector<size_t>& kernel_sizes, const vector<string>& sections){
+	string out;
+	cacheHeader H;
+	memcpy(H.magic, CACHE_MAGIC, 8);
+	H.version = VERSION;
+	H.clusters = clusters.size();
+	H.kernels = sections.size();
+	H.registers = registerSet::MAX_REGISTERS;
+	H.hash = hash;
+	H.input_size = input_size;
+	append(out, H);
+	for (int c = 0; c < clusters.size(); c++){
+		cacheSpan s;
+		s.offset = clusters[c].offset;
+		s.length = clusters[c].length;
+		append(out, s);
+	}
+
+	size_t offset = out.size() + sections.size() * sizeof(cacheKernel);
+	for (int k = 0; k < sections.size(); k++){
+		cacheKernel K;
+		K.cluster = kernel_clusters[k];
+		K.reserved = 0;
+		K.size = kernel_sizes[k];
+		K.section = offset;
+		K.section_length = sections[k].size();
+		append(out, K);
+		offset += sections[k].size();
+	}
+	for (int k = 0; k < sections.size(); k++)
+		out += sections[k];
+
+	//the file is written under a temporary name and renamed, so a reader never maps a partial cache file
+	string temporary = path + ".tmp" + to_string(getpid());
+	{
+		ofstream file(temporary.c_str(), ios::out | ios::binary | ios::trunc);
+		if (!file || !file.write(out.data(), out.size()))
+			return false;
+	}
+	if (rename(temporary.c_str(), path.c_str()) != 0){
+		remove(temporary.c_str());
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,183 @@
+/*
+ * \file    Instruction.cpp
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Implementation of the decoder of SASS instructions
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#include <cctype>
+#include <cstring>
+
+#include "../interface/Instruction.h"
+
+using namespace std;
+
+//******************************************codeRange Methods**************************************
+codeRange::codeRange(){
+	begin = end = nullptr;
+}
+
+codeRange::codeRange(const char* b, const char* e){
+	begin = b;
+	end = e;
+}
+
+size_t codeRange::size() const{
+	return end - begin;
+}
+
+size_t codeRange::find(const char* s, size_t pos) const{
+	size_t n = strlen(s);
+	size_t length = size();
+	if (n == 0)
+		return pos <= length ? pos : string::npos;
+	while (pos + n <= length){
+		const char* c = static_cast<const char*>(memchr(begin + pos, s[0], length - n + 1 - pos));
+		if (c == nullptr)
+			return string::npos;
+		pos = c - begin;
+		if (memcmp(c, s, n) == 0)
+			return pos;
+		pos++;
+	}
+	return string::npos;
+}
+
+size_t codeRange::find(const string& s, size_t pos) const{
+	return find(s.c_str(), pos);
+}
+
+codeRange codeRange::sub(size_t pos, size_t n) const{
+	size_t length = size();
+	if (pos > length)
+		pos = length;
+	if (n > length - pos)
+		n = length - pos;
+	return codeRange(begin + pos, begin + pos + n);
+}
+
+int codeRange::count(char c) const{
+	int n = 0;
+	for (const char* p = begin; p != end; p++)
+		n += *p == c;
+	return n;
+}
+
+string codeRange::str() const{
+	return string(begin, size());
+}
+
+
+//******************************************instruction Methods**************************************
+registerSet instruction::registers() const{
+	registerSet r = defs;
+	r.insert(uses);
+	return r;
+}
+
+
+//******************************************instructionDecoder Methods**************************************
+namespace {
+
+/* \brief Skips blanks; nvdisasm escapes the spaces of record labels ("\\ ")*/
+const char* skip_blanks(const char* c, const char* end){
+	while (c < end){
+		if (*c == ' ' || *c == '\t')
+			c++;
+		else if (*c == '\\' && c + 1 < end && c[1] == ' ')
+			c += 2;
+		else
+			break;
+	}
+	return c;
+}
+
+/* \brief Finds the end of a token (a blank, "," or the end of text)*/
+const char* token_end(const char* c, const char* end){
+	while (c < end && *c != ' ' && *c != '\t' && *c != ',' && !(*c == '\\' && c + 1 < end && c[1] == ' '))
+		c++;
+	return c;
+}
+
+/* \brief Instructions whose first register operand is not written (stores and reductions)*/
+bool writes_first_operand(codeRange opcode){
+	if (opcode.size() == 0)
+		return false;
+	return !(opcode.find("ST") == 0 || opcode.find("RED") == 0 || opcode.find("SUST") == 0 || opcode.find("SURED") == 0);
+}
+
+}
+
+const char* instructionDecoder::instruction_line(codeRange text){
+	//the instruction is on the last line of the text (labels and directives are on the lines before it)
+	const char* line = text.begin;
+	for (const char* c = text.begin; c + 1 < text.end; c++){
+		if (c[0] == '\\' && c[1] == 'l')
+			line = c + 2;
+	}
+	//the first instruction of a port starts after the name of the record field (e.g. "exitpost0>" or "<entry>")
+	const char* field = line;
+	if (field < text.end && *field == '<')
+		field++;
+	while (field < text.end && (isalnum((unsigned char)*field) || *field == '_'))
+		field++;
+	if (field != line && field < text.end && *field == '>')
+		line = field + 1;
+	return line;
+}
+
+instruction instructionDecoder::decode(codeRange text){
+	instruction I;
+	I.text = text;
+	I.guard = -1;
+	I.negated_guard = false;
+
+	const char* c = skip_blanks(instruction_line(text), text.end);
+	if (c < text.end && *c == '@'){
+		c++;
+		if (c < text.end && *c == '!'){
+			I.negated_guard = true;
+			c++;
+		}
+		if (c + 1 < text.end && *c == 'P'){
+			if (c[1] == 'T')
+				I.guard = 7;
+			else if (c[1] >= '0' && c[1] <= '9')
+				I.guard = c[1] - '0';
+		}
+		c = skip_blanks(token_end(c, text.end), text.end);
+	}
+
+	const char* opcode_end = token_end(c, text.end);
+	I.opcode = codeRange(c, opcode_end);
+
+	//the first operand is the destination register (if it is a register and the instruction writes it)
+	const char* operand = skip_blanks(opcode_end, text.end);
+	const char* operand_end = token_end(operand, text.end);
+	if (writes_first_operand(I.opcode) && operand + 1 < operand_end && *operand == 'R' && operand[1] >= '0' && operand[1] <= '9'){
+		I.defs.insert_operands(operand, operand_end);
+		I.uses.insert_operands(text.begin, operand);
+		I.uses.insert_operands(operand_end, text.end);
+	}
+	else
+		I.uses.insert_operands(text.begin, text.end);
+	return I;
+}
+
+int instructionDecoder::decode_all(codeRange code, vector<instruction>& stream){
+	int n = 0;
+	size_t found1 = 0; //the beginning of the instruction
+	size_t found2 = code.find(";", found1); //the end of the instruction
+	while (found2 != string::npos){
+		stream.push_back(decode(code.sub(found1, found2 - found1)));
+		n++;
+		found1 = found2 + 1;
+		found2 = code.find(";", found1);
+	}
+	return n;
+}
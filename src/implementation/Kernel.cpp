@@ -0,0 +1,622 @@
+/*
+ * \file    Kernel.cpp
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Implementation of the steps of processing a kernel (parsing, CFG creation, register-interval creation and logs)
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#include <cctype>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+
+#include "../interface/Kernel.h"
+
+using namespace std;
+
+namespace {
+
+/* \brief Can the character be a part of the name of a basic block (labels like ".L_12" and kernel names like "$_Z4funcv$__cuda_sm20_rcp_rn_f32")*/
+bool label_character(char c){
+	return isalnum((unsigned char)c) || c == '_' || c == '.' || c == '$';
+}
+
+}
+
+void parse_input_file(inputFile& input, const string& cache_directory){
+	auto begin = chrono::steady_clock::now();
+	input.cached = false;
+	input.valid = input.file.open(input.name.c_str());
+	if (input.valid && cache_directory.size() != 0){
+		input.hash = graphCache::content_hash(input.file.data(), input.file.size());
+		input.cache_name = graphCache::file_name(cache_directory, input.hash);
+		input.cached = input.cache.open(input.cache_name, input.hash, input.file.size());
+		if (input.cached)
+			input.clusters = input.cache.clusters();
+	}
+
+	if (!input.valid)
+		cerr << "Cannot open the input file: " << input.name << endl;
+	else if (!input.cached && !DotParser::parse(input.file, input.nodes, input.edges, input.clusters))
+		cerr << "Warning: " << input.name << " is not a well-formed digraph" << endl;
+	input.time = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+}
+
+vector<kernel> find_kernels(inputFile* input){
+	vector<kernel> kernels;
+	if (!input->valid)
+		return kernels;
+
+	//cluster c is kept in slot c + 1, slot 0 is for the nodes that are not in a cluster
+	vector<size_t> size(input->clusters.size() + 1, 0);
+	vector<bool> used(input->clusters.size() + 1, false);
+	for (int i = 0; i < input->nodes.size(); i++){
+		size[input->nodes[i].cluster + 1] += input->nodes[i].code.length;
+		used[input->nodes[i].cluster + 1] = true;
+	}
+	if (input->nodes.size() == 0)
+		used[0] = true; //an empty file still gets its (empty) logs
+	if (input->cached){//the kernels of the cache file are the kernels that were found when it was written
+		fill(used.begin(), used.end(), false);
+		for (int k = 0; k < input->cache.number_of_kernels(); k++){
+			size[input->cache.kernel_cluster(k) + 1] = input->cache.kernel_size(k);
+			used[input->cache.kernel_cluster(k) + 1] = true;
+		}
+	}
+
+	//the logs of a kernel are named after the file, and after the file and the kernel number when the file has several kernels
+	string File = input->name;
+	size_t slash = File.rfind("/");
+	File = File.substr(slash == string::npos ? 0 : slash + 1);
+	File = File.substr(0, File.find("."));
+
+	int count = 0;
+	for (int c = 0; c < used.size(); c++)
+		count += used[c];
+	for (int c = 0; c < used.size(); c++){
+		if (!used[c])
+			continue;
+		kernel K;
+		K.input = input;
+		K.cluster = c - 1;
+		K.index = kernels.size();
+		K.log_name = count > 1 ? File + "_" + to_string(kernels.size()) : File;
+		K.name = (count > 1 && c > 0) ? input->file.text(input->clusters[c - 1]) : "";
+		if (K.name.compare(0, 8, "cluster_") == 0)
+			K.name = K.name.substr(8);
+		K.function = c > 0 ? input->file.text(input->clusters[c - 1]) : "";
+		if (K.function.compare(0, 8, "cluster_") == 0)
+			K.function = K.function.substr(8);
+		K.size = size[c];
+		K.intervals = 0;
+		K.time = 0;
+		K.weighted_prefetches = 0;
+		K.loops = K.contained_loops = 0;
+		K.saved = false;
+		kernels.push_back(K);
+	}
+	return kernels;
+}
+
+vector<basicBlock*> kernel_basic_blocks(kernel& K, controlFlowGraph& graph, runStatistics* statistics){
+	if (K.input->cached){
+		auto begin = chrono::steady_clock::now();
+		vector<basicBlock*> basic_blocks = K.input->cache.load_kernel(K.index, K.input->file, graph);
+		if (statistics != nullptr)
+			statistics->end_phase("cache_load", begin);
+		return basic_blocks;
+	}
+
+	vector<basicBlock*> basic_blocks = create_control_flow_graph(*K.input, K.cluster, graph, statistics);
+	if (K.input->cache_name.size() != 0)
+		K.saved = graphCache::save_kernel(graph, basic_blocks, K.input->file, K.section);
+	return basic_blocks;
+}
+
+void write_cache_file(inputFile& input, const vector<kernel>& kernels){
+	if (!input.valid || input.cached || input.cache_name.size() == 0)
+		return;
+
+	vector<int> clusters;
+	vector<size_t> sizes;
+	vector<string> sections;
+	for (int k = 0; k < kernels.size(); k++){
+		if (!kernels[k].saved)
+			return;
+		clusters.push_back(kernels[k].cluster);
+		sizes.push_back(kernels[k].size);
+		sections.push_back(kernels[k].section);
+	}
+	if (!graphCache::write(input.cache_name, input.hash, input.file.size(), input.clusters, clusters, sizes, sections))
+		cerr << "Warning: cannot write the cache file " << input.cache_name << endl;
+}
+
+vector<registerInterval*> register_interval_passes(controlFlowGraph& graph, vector<basicBlock*> basic_blocks, int REGNUM, registerBudget budget, const frequencyWeighting* weighting,
+                                                   bool loop_admission, bool split_planning, double pass_time[2], double* weighted_prefetches, int loop_count[2], runStatistics* statistics){
+        //Register-interval creation algorithm (pass one) will construct the initial register-intervals from basic blocks and CFG
+	auto begin = chrono::steady_clock::now();
+	auto step = begin; //the beginning of the current step (for statistics)
+	RegisterIntervalCreationPass pass(graph);
+	pass.set_register_budget(budget);
+	pass.set_frequency_weighting(weighting);
+	pass.set_loop_admission(loop_admission);
+	pass.set_split_planning(split_planning);
+	auto intervals = pass.registerIntervalCreationPassOne(basic_blocks, REGNUM);
+	auto end = chrono::steady_clock::now();
+	pass_time[0] += chrono::duration<double, milli>(end - begin).count();
+	if (statistics != nullptr)
+		statistics->end_phase("pass_one", step);
+
+        //In the following loop, pass two of register-interval creation algorithm will be repeated until no changes occur
+	begin = end;
+	vector<registerInterval*> last; //the register-intervals before the last iteration (the last one does not reduce them)
+	int iteration = 0;
+	do
+	{
+		last = intervals;
+		intervals = pass.registerIntervalCreationPassTwo(intervals, REGNUM);
+		if (statistics != nullptr)
+			statistics->end_phase("pass_two_" + to_string(++iteration), step);
+	} while (intervals.size() < last.size()); //Pass 2 of register-interval creation algorithm will be done until the CFG can not be reduced anymore
+	pass_time[1] += chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+	if (weighting != nullptr && weighted_prefetches != nullptr)
+		*weighted_prefetches += pass.weighted_prefetch_count(last);
+	if (loop_count != nullptr){
+		loop_count[0] += pass.loop_count();
+		loop_count[1] += pass.contained_loop_count(last);
+	}
+
+	return last;
+}
+
+vector<basicBlock*> create_control_flow_graph(const inputFile& input, int cluster, controlFlowGraph& graph, runStatistics* statistics){
+    /* The control flow analysis of nvdisasm tool generates a CFG that its nodes are abstract basic blocks. So
+     we first extract the abstract basic blocks from graphviz dot code (the output of nvdisasm tool) and then  we will create basic blocks and CFG.*/
+    
+    vector<basicBlock*> abstract_basic_blocks;
+    auto begin = chrono::steady_clock::now();
+    
+    //**********************finding abstract basic blocks of the kernel*******************************
+	const mappedFile& file = input.file;
+	const vector<dotNode>& nodes = input.nodes;
+	const vector<dotEdge>& edges = input.edges;
+
+	unordered_map<string, vector<basicBlock*>> block_index; //name -> abstract basic blocks with that name (in file order)
+	for (int i = 0; i < nodes.size(); i++){
+		if (nodes[i].cluster != cluster)
+			continue;
+		auto temp = graph.new_abstract_basicBlock(file.text(nodes[i].name));
+		temp->set_code(codeRange(file.data() + nodes[i].code.offset, file.data() + nodes[i].code.offset + nodes[i].code.length));//the instructions stay in the mapped file
+		abstract_basic_blocks.push_back(temp);
+		block_index[temp->get_name()].push_back(temp);
+	}
+	//******************************************************************************************
+
+	//*********************Setting successors and predecessors of abstract basic blocks************************
+	vector<pair<basicBlock*, basicBlock*>> abstract_edges; //(predecessor, successor), nvdisasm may give an edge once for each exit
+	for (int e = 0; e < edges.size(); e++){
+		if (edges[e].cluster != cluster)
+			continue;
+		auto source = block_index.find(file.text(edges[e].source));
+		auto target = block_index.find(file.text(edges[e].target));
+		if (source == block_index.end() || target == block_index.end())
+			continue;
+
+		auto T = target->second.front();
+		for (auto s = source->second.begin(); s != source->second.end(); s++)
+			abstract_edges.push_back(make_pair(*s, T));
+	}
+	graph.connect(abstract_edges);
+	//************************************************************************************************
+	
+	if (statistics != nullptr)
+		statistics->end_phase("cfg", begin);
+	
+	//**************************Splitting abstract basic blocks to regular basic blocks***********************************
+	auto basic_blocks = split_abstract_basic_blocks(abstract_basic_blocks, graph);
+	if (statistics != nullptr)
+		statistics->end_phase("split", begin);
+	
+	//***********************Decoding instructions and extracting registers of each basicBlock***************************************
+	for (int i = 0; i < basic_blocks.size(); i++){
+		graph.decode_instructions(basic_blocks[i]);
+		registerSet registers;
+		for (int k = basic_blocks[i]->first_instruction(); k < basic_blocks[i]->last_instruction(); k++)
+			registers.insert(graph.get_instruction(k).registers());
+		basic_blocks[i]->set_output_list(registers);
+	}
+	if (statistics != nullptr)
+		statistics->end_phase("registers", begin);
+	//************************************************************************************************
+        
+        return basic_blocks;
+}
+
+vector<basicBlock*> split_abstract_basic_blocks(vector<basicBlock*> ABBs, controlFlowGraph& graph){
+	basicBlock *temp, *temp2;
+	vector<basicBlock*> controling_basicBlocks;
+	string q = "Controling_basicBlock";
+	int p = 0;
+        
+        vector<basicBlock*> basic_blocks;
+
+	//**********************Splitting Codes and Constructing new BBs***********************
+	codeRange str, str2; //ranges of the instructions (nothing is copied)
+	string name;
+	int found1 = 0;
+	int found2 = 0;
+	int foundtemp = 0;
+	int foundExit = 0;
+	vector<int> ABB_first, ABB_count; //the range of basic blocks that each abstract basic block is split into
+	for(int i = 0; i < ABBs.size(); i++){
+		ABB_first.push_back(basic_blocks.size());
+		str = ABBs[i]->get_code();
+		char tt = 'A';
+		found1 = 0;
+		found2 = str.find("<exit", found1);
+		
+		while(found2 != string::npos){
+			str2 = str.sub(found1, found2 - found1);
+
+			foundExit = str2.find("EXIT", 0);
+			foundtemp = str2.find(";", 0);
+
+			if(foundExit == string::npos){
+				if(str2.find(";", foundtemp + 1) == string::npos && str2.find("@P0", 0) != string::npos){
+					temp2 = graph.new_controling_basicBlock();
+					temp2->set_code(str2);
+					temp2->set_name(q + std::to_string(p));
+					p++;
+					temp2->set_controling();
+					controling_basicBlocks.push_back(temp2);
+
+					temp->set_control_basicBlock(temp2);
+				}
+				else{
+					temp = graph.new_basicBlock(ABBs[i]->getID());
+					temp->set_code(str2);
+					if(found1 == 0)
+						temp->set_name(ABBs[i]->get_name());
+					else{
+						temp->set_name(ABBs[i]->get_name()+tt);
+						tt++;
+					}
+					basic_blocks.push_back(temp);
+				}
+			}
+
+			found1 = found2+1;
+			found2 = str.find("<exit", found1);
+		}
+
+		str2 = str.sub(found1);
+
+		foundExit = str2.find("EXIT", 0);
+		foundtemp = str2.find(";", 0);
+		if(foundExit == string::npos){
+			if(str2.find(";", foundtemp + 1) == string::npos && str2.find("@P0", 0) != string::npos){
+				temp2 = graph.new_controling_basicBlock();
+				temp2->set_code(str2);
+				temp2->set_name(q + std::to_string(p));
+				p++;
+				temp2->set_controling();
+				controling_basicBlocks.push_back(temp2);
+
+				temp->set_control_basicBlock(temp2);
+			}
+			else{
+				temp = graph.new_basicBlock(ABBs[i]->getID());
+				temp->set_code(str2);
+				if(found1 == 0)
+					temp->set_name(ABBs[i]->get_name());
+				else{
+					temp->set_name(ABBs[i]->get_name()+tt);
+					tt++;
+				}
+				basic_blocks.push_back(temp);
+			}
+		}
+		ABB_count.push_back(basic_blocks.size() - ABB_first[i]);
+	}
+	//***********************************************************************************
+
+	//*********************Indexing the names of basic blocks****************************
+	unordered_map<string, vector<int>> name_index; //name -> positions of basic blocks with that name
+	for(int k = 0; k < basic_blocks.size(); k++){
+		name = basic_blocks[k]->get_name();
+		if(name.size() != 0){
+			name_index[name].push_back(k);
+		}
+	}
+	//***********************************************************************************
+
+	//*********************Setting Predecessors and Successors***************************
+	int firstID = 0;
+	int lastID;
+	vector<int> targets;
+	vector<pair<basicBlock*, basicBlock*>> block_edges; //(predecessor, successor), a branch target can also be the fall-through
+	for(int i = 0; i < ABBs.size(); i++){
+		auto S = ABBs[i]->get_successors();
+
+		if(ABB_count[i] > 0)
+			firstID = ABB_first[i];
+		lastID = firstID + ABB_count[i] - 1;
+
+
+		for(int j = 0; j < S.size(); j++){
+			if(S[j]->getID() == ABBs[i]->getID()+1)
+				block_edges.push_back(make_pair(basic_blocks[lastID], basic_blocks[lastID+1]));
+		}
+
+		for(int j = firstID; j < lastID; j++)
+			block_edges.push_back(make_pair(basic_blocks[j], basic_blocks[j+1]));
+
+		for(int j = firstID; j <= lastID; j++){
+			if(basic_blocks[j]->get_controling_basicBlock() != nullptr){
+				str = (basic_blocks[j]->get_controling_basicBlock())->get_code();
+
+				//every basic block whose name is a whole token of the controling instruction (delimited by characters that can not be
+				//a part of a name, e.g. "`(.L_1);"), is a target of the branch, so ".L_1" is not a target of a branch to ".L_10"
+				targets.clear();
+				for(size_t k = 0; k < str.size(); ){
+					if(!label_character(str.begin[k])){
+						k++;
+						continue;
+					}
+					size_t end = k;
+					while(end < str.size() && label_character(str.begin[end]))
+						end++;
+					auto it = name_index.find(string(str.begin + k, end - k));
+					if(it != name_index.end())
+						targets.insert(targets.end(), it->second.begin(), it->second.end());
+					k = end;
+				}
+				sort(targets.begin(), targets.end());
+				targets.erase(unique(targets.begin(), targets.end()), targets.end());
+
+				for(int k = 0; k < targets.size(); k++)
+					block_edges.push_back(make_pair(basic_blocks[j], basic_blocks[targets[k]]));
+			}
+		}
+	}
+	graph.connect(block_edges);
+        
+        return basic_blocks;
+}
+
+void basic_blocks_log(vector<basicBlock*> basic_blocks, const kernel& K){
+        resultWriter out("output/BasicBlocks_" + K.log_name + ".txt");
+	if (K.name.size() != 0)
+		out << "The kernel = " << K.name << '\n';
+        
+	out << "The number of basic_blocks = " << basic_blocks.size() << '\n';
+	for (int i = 0; i < basic_blocks.size(); i++){
+		out << " #The basic_block ID : " << basic_blocks[i]->getID() << '\n';
+		out << "		#Number of Instructions = " << basic_blocks[i]->numberOfInstructions() << '\n';
+		out << "		#Register_list = {";
+		set<string> L = basic_blocks[i]->get_output_list().names();
+		set<string>::iterator it;
+		for (it = L.begin(); it != L.end(); it++)
+			out << *it << " ";
+		out << "}; #Number of Registers = " << L.size() << ";" << '\n';
+		auto P = basic_blocks[i]->get_predecessors();
+		auto S = basic_blocks[i]->get_successors();
+		out << "		#predecessors = {";
+		for(int j=0;j<P.size();j++){
+			out << P[j]->getID() << " ";
+		}
+		out << "};		#successors = {";
+		for(int j=0;j<S.size();j++){
+			out << S[j]->getID() << " ";
+		}
+		out <<"};" << '\n';
+	}
+}
+
+void registerInterval_log(vector<registerInterval*> intervals, const kernel& K){
+        resultWriter out("output/registerIntervals_" + K.log_name + ".txt");
+	if (K.name.size() != 0)
+		out << "The kernel = " << K.name << '\n';
+        
+	out << "The number of Intervals = " << intervals.size() << '\n';
+	for (int i = 0; i < intervals.size(); i++){
+		out << " #Interval ID = " << intervals[i]->getID() << " #Number of Instructions = " << intervals[i]->getNumberOfInstructions() << '\n';
+		out << "		 #Register_list = {";
+		set<string> L = intervals[i]->get_register_list().names();
+		set<string>::iterator it;
+		for (it = L.begin(); it != L.end(); it++)
+			out << *it << " ";
+		out << "}; #Number of Registers = " << L.size() << ";" << '\n';
+			
+		auto ii = intervals[i]->get_predecessors();
+		out <<"		Predecessors = { ";
+		for(int j = 0; j < ii.size(); j++){
+			out << ii[j]->getID() << " ";
+		}
+
+		ii = intervals[i]->get_successors();
+		out << "}		Successors = { ";
+		for(int j = 0; j < ii.size(); j++){
+			out << ii[j]->getID() << " ";
+		}
+		out << "};" << '\n';
+	}
+}
+
+void structured_logs(controlFlowGraph& graph, const vector<registerInterval*>& intervals, const kernel& K, logFormat format){
+	string extension = format == LOG_JSONL ? ".jsonl" : ".csv";
+
+	//the register-interval of each basic block (by ID)
+	vector<int> interval_of(graph.number_of_basicBlocks(), -1);
+	for (int i = 0; i < intervals.size(); i++){
+		auto& B = intervals[i]->get_basic_blocks();
+		for (int b = 0; b < B.size(); b++)
+			interval_of[B[b]->getID()] = intervals[i]->getID();
+	}
+
+	//a list of IDs is a JSON array, or the IDs separated by spaces in one CSV field
+	auto write_IDs = [format](resultWriter& out, const vector<int>& IDs){
+		out << (format == LOG_JSONL ? "[" : "");
+		for (int j = 0; j < IDs.size(); j++)
+			out << (j == 0 ? "" : (format == LOG_JSONL ? "," : " ")) << IDs[j];
+		out << (format == LOG_JSONL ? "]" : "");
+	};
+	vector<int> IDs;
+
+	//**********************basic blocks (after splitting)*******************************
+	{
+		resultWriter out("output/BasicBlocks_" + K.log_name + extension);
+		if (format == LOG_CSV)
+			out << "kernel,block,name,abb,instructions,registers,register_count,interval,predecessors,successors\n";
+		for (int ID = 0; ID < graph.number_of_basicBlocks(); ID++){
+			auto b = graph.basic_block(ID);
+			registerSet R = b->get_output_list();
+			if (format == LOG_JSONL){
+				out << "{\"kernel\":";
+				out.json_string(K.name);
+				out << ",\"block\":" << ID << ",\"name\":";
+				out.json_string(b->get_name());
+				out << ",\"abb\":" << b->get_ABB() << ",\"instructions\":" << b->numberOfInstructions()
+				    << ",\"registers\":\"" << R.bitmask() << "\",\"register_count\":" << R.size() << ",\"interval\":" << interval_of[ID] << ",\"predecessors\":";
+			}
+			else{
+				out.csv_field(K.name);
+				out << ',' << ID << ',';
+				out.csv_field(b->get_name());
+				out << ',' << b->get_ABB() << ',' << b->numberOfInstructions() << ',' << R.bitmask() << ',' << R.size() << ',' << interval_of[ID] << ',';
+			}
+
+			auto P = b->get_predecessors();
+			IDs.clear();
+			for (int j = 0; j < P.size(); j++)
+				IDs.push_back(P[j]->getID());
+			write_IDs(out, IDs);
+			out << (format == LOG_JSONL ? ",\"successors\":" : ",");
+			auto S = b->get_successors();
+			IDs.clear();
+			for (int j = 0; j < S.size(); j++)
+				IDs.push_back(S[j]->getID());
+			write_IDs(out, IDs);
+			out << (format == LOG_JSONL ? "}\n" : "\n");
+		}
+	}
+
+	//**********************register-intervals*******************************
+	resultWriter out("output/registerIntervals_" + K.log_name + extension);
+	if (format == LOG_CSV)
+		out << "kernel,interval,instructions,registers,register_count,live_in,live_in_count,no_writeback,no_writeback_count,blocks,predecessors,successors\n";
+	for (int i = 0; i < intervals.size(); i++){
+		registerSet R = intervals[i]->get_register_list();
+		registerSet L = intervals[i]->get_live_in_list();
+		registerSet W = intervals[i]->get_no_writeback_list();
+		if (format == LOG_JSONL){
+			out << "{\"kernel\":";
+			out.json_string(K.name);
+			out << ",\"interval\":" << intervals[i]->getID() << ",\"instructions\":" << intervals[i]->getNumberOfInstructions()
+			    << ",\"registers\":\"" << R.bitmask() << "\",\"register_count\":" << R.size()
+			    << ",\"live_in\":\"" << L.bitmask() << "\",\"live_in_count\":" << L.size()
+			    << ",\"no_writeback\":\"" << W.bitmask() << "\",\"no_writeback_count\":" << W.size() << ",\"blocks\":";
+		}
+		else{
+			out.csv_field(K.name);
+			out << ',' << intervals[i]->getID() << ',' << intervals[i]->getNumberOfInstructions() << ',' << R.bitmask() << ',' << R.size()
+			    << ',' << L.bitmask() << ',' << L.size() << ',' << W.bitmask() << ',' << W.size() << ',';
+		}
+
+		auto& B = intervals[i]->get_basic_blocks();
+		IDs.clear();
+		for (int j = 0; j < B.size(); j++)
+			IDs.push_back(B[j]->getID());
+		write_IDs(out, IDs);
+		out << (format == LOG_JSONL ? ",\"predecessors\":" : ",");
+		auto P = intervals[i]->get_predecessors();
+		IDs.clear();
+		for (int j = 0; j < P.size(); j++)
+			IDs.push_back(P[j]->getID());
+		write_IDs(out, IDs);
+		out << (format == LOG_JSONL ? ",\"successors\":" : ",");
+		auto S = intervals[i]->get_successors();
+		IDs.clear();
+		for (int j = 0; j < S.size(); j++)
+			IDs.push_back(S[j]->getID());
+		write_IDs(out, IDs);
+		out << (format == LOG_JSONL ? "}\n" : "\n");
+	}
+}
+
+void annotated_sass_log(controlFlowGraph& graph, const vector<registerInterval*>& intervals, const kernel& K, registerBudget budget){
+	resultWriter out("output/AnnotatedSASS_" + K.log_name + ".sass");
+
+	//the register-interval of each basic block (by ID)
+	vector<registerInterval*> interval_of(graph.number_of_basicBlocks(), nullptr);
+	for (int i = 0; i < intervals.size(); i++){
+		auto& B = intervals[i]->get_basic_blocks();
+		for (int b = 0; b < B.size(); b++)
+			interval_of[B[b]->getID()] = intervals[i];
+	}
+
+	//each basic block starts at the line of its first instruction; the basic blocks that are entered from another register-interval
+	//(or are entries of the kernel) start with a PREFETCH of the registers of their register-interval
+	//(a basic block without instructions at the end of the instruction stream has no line; it has no registers to prefetch)
+	vector<pair<const char*, basicBlock*>> starts;
+	for (int ID = 0; ID < graph.number_of_basicBlocks(); ID++){
+		auto b = graph.basic_block(ID);
+		if (b->first_instruction() < graph.number_of_instructions())
+			starts.push_back(make_pair(instructionDecoder::instruction_line(graph.get_instruction(b->first_instruction()).text), b));
+	}
+	stable_sort(starts.begin(), starts.end(), [](const pair<const char*, basicBlock*>& a, const pair<const char*, basicBlock*>& b){ return a.first < b.first; });
+
+	//************************the code of the abstract basic blocks (the nodes of the kernel in file order) without the Dot escapes*************************
+	const char* data = K.input->file.data();
+	int next = 0;
+	for (int n = 0; n < K.input->nodes.size(); n++){
+		if (K.input->nodes[n].cluster != K.cluster)
+			continue;
+		const char* c = data + K.input->nodes[n].code.offset;
+		const char* end = c + K.input->nodes[n].code.length;
+		while (next < starts.size() && starts[next].first < c)
+			next++;
+		while (c < end){
+			for (; next < starts.size() && starts[next].first <= c; next++){
+				auto b = starts[next].second;
+				auto i = interval_of[b->getID()];
+				out << "/* basic block " << b->get_name();
+				if (i == nullptr){
+					out << " */\n";
+					continue;
+				}
+				out << " (register-interval " << i->getID() << ") */\n";
+				auto P = b->get_predecessors();
+				bool entry = P.size() == 0;
+				for (int p = 0; p < P.size(); p++)
+					entry = entry || interval_of[P[p]->getID()] != i;
+				if (entry)
+					out << "  PREFETCH " << (budget == BUDGET_LIVE_IN ? i->get_live_in_list() : i->get_register_list()).bitmask()
+					    << ";    /* no-writeback " << i->get_no_writeback_list().bitmask() << " */\n";
+			}
+			if (*c == '\\' && c + 1 < end){
+				out << (c[1] == 'l' || c[1] == 'n' ? '\n' : c[1]);
+				c += 2;
+			}
+			else if (*c == '|')
+				c++;
+			else if (*c == '<'){//the name of a record field (e.g. "<exit0>")
+				while (c < end && *c != '>')
+					c++;
+				c++;
+			}
+			else
+				out << *c++;
+		}
+		out << '\n';
+	}
+}
@@ -0,0 +1,144 @@
+/*
+ * \file    Liveness.cpp
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Implementation of the liveness analysis of registers over the basic block CFG
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#include <algorithm>
+#include <queue>
+#include <utility>
+
+#include "../interface/Liveness.h"
+
+using namespace std;
+
+namespace {
+
+/* \brief Does the instruction always write its destination (it is not guarded, or it is guarded by PT)*/
+bool always_defines(const instruction& I){
+	return I.guard == -1 || (I.guard == 7 && !I.negated_guard);
+}
+
+}
+
+void livenessAnalysis::build(const vector<basicBlock*>& blocks, controlFlowGraph& graph){
+	int n = 0;
+	for (auto b = blocks.begin(); b != blocks.end(); b++)
+		n = max(n, (*b)->getID() + 1);
+	in.assign(n, registerSet());
+	out.assign(n, registerSet());
+
+	/* The live registers before a basic block are its uses (read before written in it) and the live registers after it that it does not define*/
+	vector<registerSet> uses(n), definitions(n);
+	vector<pair<int, int>> edges; //(basic block, predecessor)
+	for (auto b = blocks.begin(); b != blocks.end(); b++){
+		int x = (*b)->getID();
+		uses[x] = transfer(graph, (*b)->first_instruction(), (*b)->last_instruction(), registerSet());
+		for (int k = (*b)->first_instruction(); k < (*b)->last_instruction(); k++){
+			if (always_defines(graph.get_instruction(k)))
+				definitions[x].insert(graph.get_instruction(k).defs);
+		}
+		auto P = (*b)->get_predecessors();
+		for (auto p = P.begin(); p != P.end(); p++)
+			edges.push_back(make_pair(x, (*p)->getID()));
+	}
+	csrAdjacency predecessors, successors;
+	predecessors.build(n, edges);
+	for (int e = 0; e < edges.size(); e++)
+		swap(edges[e].first, edges[e].second);
+	successors.build(n, edges);
+
+	//************************The data-flow analysis (a basic block is visited again when the live-in registers of a successor change)*************************
+	queue<int> work;
+	vector<bool> queued(n, false);
+	for (int k = (int)blocks.size() - 1; k >= 0; k--){//backward analysis: the last basic blocks first
+		work.push(blocks[k]->getID());
+		queued[blocks[k]->getID()] = true;
+	}
+	while (!work.empty()){
+		int x = work.front();
+		work.pop();
+		queued[x] = false;
+
+		registerSet live;
+		for (auto s = successors.begin(x); s != successors.end(x); s++)
+			live.insert(in[*s]);
+		out[x] = live;
+		live.remove(definitions[x]);
+		live.insert(uses[x]);
+		if (live == in[x])
+			continue;
+		in[x] = live;
+		for (auto p = predecessors.begin(x); p != predecessors.end(x); p++){
+			if (!queued[*p]){
+				queued[*p] = true;
+				work.push(*p);
+			}
+		}
+	}
+}
+
+void livenessAnalysis::split(basicBlock* b, basicBlock* second, controlFlowGraph& graph){
+	vector<basicBlock*> parts;
+	parts.push_back(b);
+	parts.push_back(second);
+	split(parts, graph);
+}
+
+void livenessAnalysis::split(const vector<basicBlock*>& parts, controlFlowGraph& graph){
+	int x = parts[0]->getID();
+	int n = (int)in.size();
+	for (auto p = parts.begin() + 1; p != parts.end(); p++)
+		n = max(n, (*p)->getID() + 1);
+	in.resize(n);
+	out.resize(n);
+
+	//backward from the last part, which ends where the old basic block ended
+	registerSet live = out[x];
+	for (int k = (int)parts.size() - 1; k > 0; k--){
+		int y = parts[k]->getID();
+		out[y] = live;
+		live = transfer(graph, parts[k]->first_instruction(), parts[k]->last_instruction(), live);
+		in[y] = live;
+	}
+	out[x] = live;
+}
+
+registerSet livenessAnalysis::live_in(basicBlock* b) const{
+	int x = b->getID();
+	return x < (int)in.size() ? in[x] : registerSet();
+}
+
+registerSet livenessAnalysis::live_out(basicBlock* b) const{
+	int x = b->getID();
+	return x < (int)out.size() ? out[x] : registerSet();
+}
+
+registerSet livenessAnalysis::transfer(controlFlowGraph& graph, int first, int last, registerSet live){
+	for (int k = last - 1; k >= first; k--){
+		const instruction& I = graph.get_instruction(k);
+		if (leaves_function(I))
+			live = all_registers();
+		if (always_defines(I))
+			live.remove(I.defs);
+		live.insert(I.uses);
+	}
+	return live;
+}
+
+bool livenessAnalysis::leaves_function(const instruction& I){
+	return I.opcode.find("CAL") == 0 || I.opcode.find("JCAL") == 0 || I.opcode.find("RET") == 0;
+}
+
+registerSet livenessAnalysis::all_registers(){
+	registerSet all;
+	for (int r = 0; r < registerSet::MAX_REGISTERS; r++)
+		all.insert(r);
+	return all;
+}
@@ -0,0 +1,132 @@
+/*
+ * \file    LoopForest.cpp
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Implementation of the natural loops of the basic block CFG
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#include <algorithm>
+
+#include "../interface/LoopForest.h"
+
+using namespace std;
+
+void loopForest::build(const vector<basicBlock*>& blocks, dominatorTree& dominators){
+	headers.clear();
+	loops.clear();
+	parents.clear();
+	loop_depth.clear();
+
+	int n = 0;
+	vector<int> position; //the position of each basic block (by ID) in blocks
+	for (auto b = blocks.begin(); b != blocks.end(); b++)
+		n = max(n, (*b)->getID() + 1);
+	position.assign(n, -1);
+	for (int k = 0; k < blocks.size(); k++)
+		position[blocks[k]->getID()] = k;
+	innermost.assign(n, -1);
+
+	//************************The natural loop of each header: the basic blocks found backwards from its back edges*************************
+	epochMarks body;
+	vector<basicBlock*> work;
+	for (auto h = blocks.begin(); h != blocks.end(); h++){
+		auto P = (*h)->get_predecessors();
+		body.next_epoch();
+		body.mark((*h)->getID());
+		vector<basicBlock*> L(1, *h);
+		for (auto p = P.begin(); p != P.end(); p++){
+			if (position[(*p)->getID()] != -1 && dominators.dominates(*h, *p) && body.mark((*p)->getID())){
+				L.push_back(*p);
+				work.push_back(*p);
+			}
+		}
+		if (L.size() == 1 && find(P.begin(), P.end(), *h) == P.end())
+			continue; //no back edge
+		while (!work.empty()){
+			auto b = work.back();
+			work.pop_back();
+			auto Q = b->get_predecessors();
+			for (auto q = Q.begin(); q != Q.end(); q++){
+				if (position[(*q)->getID()] != -1 && body.mark((*q)->getID())){
+					L.push_back(*q);
+					work.push_back(*q);
+				}
+			}
+		}
+		sort(L.begin() + 1, L.end(), [&position](basicBlock* a, basicBlock* b){ return position[a->getID()] < position[b->getID()]; });
+		headers.push_back(*h);
+		loops.push_back(L);
+	}
+
+	//************************Nesting: the innermost loop of a basic block (or a header) is the smallest loop that contains it*************************
+	vector<int> order(loops.size());
+	for (int l = 0; l < loops.size(); l++)
+		order[l] = l;
+	stable_sort(order.begin(), order.end(), [this](int a, int b){ return loops[a].size() < loops[b].size(); });
+	parents.assign(loops.size(), -1);
+	vector<int> loop_of_header(n, -1);
+	for (int l = 0; l < loops.size(); l++)
+		loop_of_header[headers[l]->getID()] = l;
+	for (int k = 0; k < order.size(); k++){
+		int l = order[k];
+		for (auto b = loops[l].begin(); b != loops[l].end(); b++){
+			int x = (*b)->getID();
+			if (innermost[x] == -1)
+				innermost[x] = l;
+			int m = loop_of_header[x];
+			if (m != -1 && m != l && parents[m] == -1)
+				parents[m] = l;
+		}
+	}
+	loop_depth.assign(loops.size(), 0);
+	for (int k = (int)order.size() - 1; k >= 0; k--){//outer loops are larger
+		int l = order[k];
+		loop_depth[l] = parents[l] == -1 ? 1 : loop_depth[parents[l]] + 1;
+	}
+}
+
+void loopForest::split(basicBlock* b, basicBlock* second){
+	int x = b->getID();
+	int y = second->getID();
+	if (y >= (int)innermost.size())
+		innermost.resize(y + 1, -1);
+	innermost[y] = x < (int)innermost.size() ? innermost[x] : -1;
+	for (int l = innermost[y]; l != -1; l = parents[l])
+		loops[l].push_back(second);
+}
+
+int loopForest::number_of_loops() const{
+	return loops.size();
+}
+
+basicBlock* loopForest::header(int loop) const{
+	return headers[loop];
+}
+
+const vector<basicBlock*>& loopForest::loop_blocks(int loop) const{
+	return loops[loop];
+}
+
+int loopForest::parent(int loop) const{
+	return parents[loop];
+}
+
+int loopForest::header_loop(basicBlock* b) const{
+	int l = innermost_loop(b);//a loop contains the loops whose headers it contains, so the innermost loop of a header is its own loop
+	return l != -1 && headers[l] == b ? l : -1;
+}
+
+int loopForest::innermost_loop(basicBlock* b) const{
+	int x = b->getID();
+	return x < (int)innermost.size() ? innermost[x] : -1;
+}
+
+int loopForest::depth(basicBlock* b) const{
+	int l = innermost_loop(b);
+	return l == -1 ? 0 : loop_depth[l];
+}
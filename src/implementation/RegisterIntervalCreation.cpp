@@ -13,17 +13,107 @@
 #include <vector>
 #include <set>
 #include <queue>
+#include <algorithm>
+#include <functional>
 
 #include "../interface/RegisterIntervalCreation.h"
 
 using namespace std;
 
-vector<basicBlock*> basic_blocks; //set of all basic blocks of application
-vector<registerInterval*> RegisterIntervals; //the set of register-intervals that contains the final register-intervals
-queue<basicBlock*> WS; //The Working Set of register-interval creation algorithm (Pass 1)
+/* \brief Orders basic blocks and register-intervals by ID, so the order in which new register-intervals are created does not depend on heap addresses*/
+struct compareID{
+	template<typename T> bool operator()(T* a, T* b) const { return a->getID() < b->getID(); }
+};
 
-vector<bool> mark; //The bit vector that is used to mark predecessors of basic blocks
-vector<bool> registerInterval_mark; //The bit vector that is used to mark predecessors of register-intervals
+/* \brief Orders basic blocks by their position (indexed by ID)*/
+struct comparePosition{
+	const vector<int>& position;
+	comparePosition(const vector<int>& p) : position(p) {}
+	bool operator()(basicBlock* a, basicBlock* b) const { return position[a->getID()] < position[b->getID()]; }
+};
+
+RegisterIntervalCreationPass::RegisterIntervalCreationPass(controlFlowGraph& g) : graph(g), budget(BUDGET_ALL_REGISTERS), weighted(false), loop_admission(false), split_planning(false) {}
+
+void RegisterIntervalCreationPass::set_register_budget(registerBudget b){
+	budget = b;
+}
+
+void RegisterIntervalCreationPass::set_frequency_weighting(const frequencyWeighting* w){
+	weighted = w != nullptr;
+	if (weighted)
+		weighting = *w;
+}
+
+void RegisterIntervalCreationPass::set_loop_admission(bool admission){
+	loop_admission = admission;
+}
+
+void RegisterIntervalCreationPass::set_split_planning(bool planning){
+	split_planning = planning;
+}
+
+void RegisterIntervalCreationPass::set_entry(registerInterval* interval, basicBlock* entry){
+	if (interval->getID() >= (int)entries.size())
+		entries.resize(interval->getID() + 1, nullptr);
+	entries[interval->getID()] = entry;
+}
+
+basicBlock* RegisterIntervalCreationPass::entry_block(registerInterval* interval) const{
+	return interval->getID() < (int)entries.size() ? entries[interval->getID()] : nullptr;
+}
+
+double RegisterIntervalCreationPass::entry_frequency(registerInterval* interval) const{
+	basicBlock* entry = entry_block(interval);
+	return weighted && entry != nullptr ? frequencies.frequency(entry) : 0;
+}
+
+double RegisterIntervalCreationPass::frontier_weight(basicBlock* block) const{
+	return weighted ? -frequencies.frequency(block) : 0;
+}
+
+int RegisterIntervalCreationPass::loop_count() const{
+	return loops.number_of_loops();
+}
+
+int RegisterIntervalCreationPass::contained_loop_count(const vector<registerInterval*>& intervals){
+	vector<registerInterval*> interval_of(graph.number_of_basicBlocks(), nullptr);
+	for (auto i = intervals.begin(); i != intervals.end(); i++){
+		auto& B = (*i)->get_basic_blocks();
+		for (auto b = B.begin(); b != B.end(); b++)
+			interval_of[(*b)->getID()] = *i;
+	}
+	int contained = 0;
+	for (int l = 0; l < loops.number_of_loops(); l++){
+		auto& L = loops.loop_blocks(l);
+		bool C = true;
+		for (auto x = L.begin(); x != L.end() && C; x++)
+			C = interval_of[(*x)->getID()] == interval_of[L[0]->getID()];
+		contained += C;
+	}
+	return contained;
+}
+
+double RegisterIntervalCreationPass::weighted_prefetch_count(const vector<registerInterval*>& intervals) const{
+	double count = 0;
+	for (auto i = intervals.begin(); i != intervals.end(); i++)
+		count += entry_frequency(*i);
+	return count;
+}
+
+int RegisterIntervalCreationPass::budget_size(const registerSet& registers, const registerSet& entry_live) const{
+	if (budget == BUDGET_LIVE_IN)
+		return registers.intersection_size(entry_live);
+	return registers.size();
+}
+
+int RegisterIntervalCreationPass::budget_union_size(const registerSet& a, const registerSet& b, const registerSet& entry_live) const{
+	if (budget == BUDGET_LIVE_IN){
+		registerSet registers = a;
+		registers.insert(b);
+		return registers.intersection_size(entry_live);
+	}
+	return a.union_size(b);
+}
 
 vector<registerInterval*> RegisterIntervalCreationPass::registerIntervalCreationPassOne(vector<basicBlock*> BB_vector, int N){ //N is the maximum number of registers allowed in a register-interval 
         basic_blocks = BB_vector;
@@ -34,13 +124,37 @@ vector<registerInterval*> RegisterIntervalCreationPass::registerIntervalCreation
 		(*b)->set_registerInterval(nullptr);
 	}
 
+	dominators.build(basic_blocks);
+	int n = graph.number_of_basicBlocks(); //IDs of basic blocks are less than n
+	reaching_registers.assign(n, registerSet());
+	block_position.assign(n, -1);
+	vector<pair<int, int>> edges; //(predecessor, basic block)
+	for (int k = 0; k < basic_blocks.size(); k++){
+		block_position[basic_blocks[k]->getID()] = k;
+		auto P = basic_blocks[k]->get_predecessors();
+		for (auto p = P.begin(); p != P.end(); p++)
+			edges.push_back(make_pair((*p)->getID(), basic_blocks[k]->getID()));
+	}
+	dependents.build(n, edges);
+	liveness.build(basic_blocks, graph);
+	loops.build(basic_blocks, dominators);
+	if (weighted){
+		if (weighting.profile != nullptr)
+			frequencies.read_profile(basic_blocks, *weighting.profile, weighting.kernel);
+		else
+			frequencies.estimate(basic_blocks, loops);
+	}
+
 	RegisterIntervals.clear();
 	for(auto b = basic_blocks.begin(); b != basic_blocks.end(); b++){
 		auto Predecessors = (*b)->get_predecessors();
 		if(Predecessors.size() == 0){ // each basic block with no predecessors is assumed as an entry basicBlock
-			auto temp = new registerInterval();
+			auto temp = graph.new_registerInterval();
 			RegisterIntervals.push_back(temp);
 			(*b)->set_registerInterval(temp);
+			temp->set_entry_live_list(liveness.live_in(*b));
+			set_entry(temp, *b);
+			temp->add_basic_block(*b);
 			WS.push(*b);// The entry basic block is added to the working set of registerInterval creation algorithm
 		}
 	}
@@ -48,323 +162,607 @@ vector<registerInterval*> RegisterIntervalCreationPass::registerIntervalCreation
 	while (!WS.empty()){
 		auto BB = WS.front(); //Get one basic blocks from working set
 		WS.pop();
-		auto i = BB->RegisterInterval(); //Get the register-interval that this basic block belongs to
+		auto i = BB->RegisterInterval(); //Get the register-interval that this basic block belongs to (BB is its entry)
+		registerSet entry_live = i->get_entry_live_list();
 		traverse(BB, N); //Traversing the basic block and splitting it if it has more than the allowed number of registers
-		if (BB->numberOfRegisters() < N){
+		registerSet regList = BB->get_output_list();//the register list of register-interval
+		if (budget_size(BB->get_output_list(), entry_live) < N){
+                        /* A basic block can join i only if all of its predecessors belong to i, so i is single-entry and its entry (BB) dominates
+                           all of its basic blocks. The registers of the blocks of i that can reach a candidate are:
+                                - the registers of the blocks of i that are on a common cycle with BB (they reach BB and BB reaches every block of i)
+                                - the reaching_registers of the candidate's predecessors (blocks that reach it through i without passing BB)*/
+			registerSet cycle_registers = BB->get_output_list();
+
+                        /* Only the frontier of i (the basic blocks that have a predecessor in i) are candidates. They are visited in the order of
+                           basic_blocks and each of them at most once (it is marked when it joins the frontier), so a basic block that joins the
+                           frontier behind the last visited candidate is not visited. With frequency weighting they are visited hottest first
+                           (and then in the order of basic_blocks), and a basic block that joins the frontier is visited wherever it is*/
+			priority_queue<pair<pair<double, int>, basicBlock*>, vector<pair<pair<double, int>, basicBlock*>>, greater<pair<pair<double, int>, basicBlock*>>> frontier;
+			frontier_marks.next_epoch();
+			for (auto d = dependents.begin(BB->getID()); d != dependents.end(BB->getID()); d++){
+				auto D = graph.basic_block(*d);
+				if (D->RegisterInterval() == nullptr && frontier_marks.mark(*d))
+					frontier.push(make_pair(make_pair(frontier_weight(D), block_position[*d]), D));
+			}
+
                         //In this loop we will add all eligible basic blocks to the current registerInterval (i)
-			for (auto b = basic_blocks.begin(); b != basic_blocks.end(); b++){
-				set<string> Union;//The set that will contain the union of register sets of all basic blocks of i
-                                Union.clear();
-				bool C = true;//This boolean determines that the basicBlock is reachable only from the current register-interval (in other words, its all predecessors should belong to the current register-interval)
+			while (!frontier.empty()){
+				int k = frontier.top().first.second;
+				auto b = frontier.top().second;
+				frontier.pop();
+				COUNT_EVENT(EVENT_ELIGIBILITY_CHECK);
+
+				if (b->RegisterInterval() != nullptr //the basic block should not belong to another register-interval
+                                        || !dominators.dominates(BB, b) //the basic block can be entered only through the entry of i
+                                        )
+					continue;
 
-				visit_all_predecessors(*b);//marks all basic blocks that can reach this basic block
-
-				Union = (*b)->get_output_list();
-                                //This loop will add all registers of marked basic blocks that belong to the current register-interval (i)
-				for(auto bb = basic_blocks.begin(); bb != basic_blocks.end(); bb++){
-					if(mark[(*bb)->getID()]){
-						if((*bb)->RegisterInterval() == i){
-							auto s = (*bb)->get_output_list();
-							for (auto it = s.begin(); it != s.end(); it++){
-								Union.insert(*it);
-							}
-						}
-					}
-				}
-		
-				//This loop determines the boolean value of C
-				auto P = (*b)->get_predecessors();
+				bool C = true;//This boolean determines that the basicBlock is reachable only from the current register-interval (in other words, its all predecessors should belong to the current register-interval)
+				auto P = b->get_predecessors();
                                 for(auto p = P.begin(); p != P.end(); p++){
+                                        COUNT_EVENT(EVENT_PREDECESSOR_VISIT);
                                         if((*p)->RegisterInterval() != i)
                                                 C = false;
                                 }
+				if (!C && loop_admission && loops.header_loop(b) != -1){
+                                        /* A loop header can not join i alone (its back edges come from its loop), but its whole loop can: the loop is entered
+                                           only through its header, so i stays single-entry if the other predecessors of the header belong to i*/
+					auto& L = loops.loop_blocks(loops.header_loop(b));
+					bool admissible = true;
+					loop_marks.next_epoch();
+					for (auto x = L.begin(); x != L.end(); x++){
+						loop_marks.mark((*x)->getID());
+						if ((*x)->RegisterInterval() != nullptr)
+							admissible = false; //a part of the loop is already in a register-interval (e.g. the second half of a split basic block)
+					}
+					registerSet outside_reaching; //the registers of the blocks of i that reach the loop without passing BB
+					for (auto p = P.begin(); p != P.end(); p++){
+						if (loop_marks.marked((*p)->getID()))
+							continue;
+						if ((*p)->RegisterInterval() != i)
+							admissible = false;
+						else if (*p != BB)
+							outside_reaching.insert(reaching_registers[(*p)->getID()]);
+					}
+					if (!admissible)
+						continue;
+
+					registerSet loop_registers;
+					for (auto x = L.begin(); x != L.end(); x++)
+						loop_registers.insert((*x)->get_output_list());
+					registerSet Union = loop_registers; //every block of the loop reaches all the others
+					Union.insert(cycle_registers);
+					Union.insert(outside_reaching);
+					if (budget_size(Union, entry_live) >= N)
+						continue;
+
+					registerSet reaching = loop_registers;
+					reaching.insert(outside_reaching);
+					for (auto x = L.begin(); x != L.end(); x++){
+						(*x)->set_registerInterval(i);
+						(*x)->set_input_list(Union);
+						i->add_basic_block(*x);
+						traverse(*x, N); //no basic block of the loop has more registers than Union, so none of them is split
+						reaching_registers[(*x)->getID()] = reaching;
+					}
+					if (dominators.same_component(b, BB))
+						cycle_registers.insert(loop_registers);
+					regList.insert(loop_registers);
+
+					//the basic blocks that depend on the loop (its exits) join the frontier
+					for (auto x = L.begin(); x != L.end(); x++){
+						for (auto d = dependents.begin((*x)->getID()); d != dependents.end((*x)->getID()); d++){
+							auto D = graph.basic_block(*d);
+							if (D->RegisterInterval() == nullptr && frontier_marks.mark(*d))
+								frontier.push(make_pair(make_pair(frontier_weight(D), block_position[*d]), D));
+						}
+					}
+					continue;
+				}
+				if (!C)
+					continue;
+
+				registerSet Union = b->get_output_list();//The set that will contain the union of registers of the basic block and all basic blocks of i that can reach it
+				Union.insert(cycle_registers);
+				for(auto p = P.begin(); p != P.end(); p++){
+					if(*p != BB)
+						Union.insert(reaching_registers[(*p)->getID()]);
+				}
 
 				//If this basic block is eligible, it will be added to the current register-interval
-				if ((*b)->RegisterInterval() == nullptr //the basic block should not belong to another register-interval
-                                        && C  //All predecessors of the basic block should belong to the current register-interval
-                                        && Union.size() < N //The union of all registers of the basic block and current register-interval should not be more than the allowed number
-                                        )
+				if (budget_size(Union, entry_live) < N)//The union of all registers of the basic block and current register-interval should not be more than the allowed number
                                 {
-					(*b)->set_registerInterval(i);
-					(*b)->set_input_list(Union);
-					traverse((*b), N);
+					b->set_registerInterval(i);
+					b->set_input_list(Union);
+					i->add_basic_block(b);
+					traverse(b, N);
+
+					//the registers of the basic block are known after it is traversed (and split if needed)
+					registerSet reaching = b->get_output_list();
+					for(auto p = P.begin(); p != P.end(); p++){
+						if(*p != BB)
+							reaching.insert(reaching_registers[(*p)->getID()]);
+					}
+					reaching_registers[b->getID()] = reaching;
+					if(dominators.same_component(b, BB))
+						cycle_registers.insert(b->get_output_list());
+					regList.insert(b->get_output_list());
+
+					//the basic blocks that depend on b join the frontier
+					for (auto d = dependents.begin(b->getID()); d != dependents.end(b->getID()); d++){
+						auto D = graph.basic_block(*d);
+						if (D->RegisterInterval() == nullptr && (weighted || block_position[*d] > k) && frontier_marks.mark(*d))
+							frontier.push(make_pair(make_pair(frontier_weight(D), block_position[*d]), D));
+					}
 				}
 			}
 		}
+		i->set_register_list(regList);
                 //At this point no more basic blocks can be added to the current register-interval
 
-                set<basicBlock*> Successors; //Successors will contain all successors of the current register-interval (i)
-		Successors.clear();
+                vector<basicBlock*> Successors; //Successors will contain all successors of the current register-interval (i), each of them once and in the order of IDs
                 
                 //This loop will add all successors of the current registerInterval to Successors set
-		for (auto b = basic_blocks.begin(); b != basic_blocks.end(); b++){
-			if ((*b)->RegisterInterval() == i){
-				auto S = (*b)->get_successors();
-				for (auto s = S.begin(); s != S.end(); s++){
-					if ((*s)->RegisterInterval() != i)
-						Successors.insert(*s);
-				}
+		successor_marks.next_epoch();
+		auto& B = i->get_basic_blocks();
+		for (auto b = B.begin(); b != B.end(); b++){
+			auto S = (*b)->get_successors();
+			for (auto s = S.begin(); s != S.end(); s++){
+				if ((*s)->RegisterInterval() != i && successor_marks.mark((*s)->getID()))
+					Successors.push_back(*s);
 			}
 		}
+		sort(Successors.begin(), Successors.end(), compareID());
                 
                 //This loop will assign new register-intervals to the successors of the current register-interval
-		set<basicBlock*>::iterator it2;
 		for (auto s = Successors.begin(); s != Successors.end(); s++){
 			if ((*s)->RegisterInterval() == nullptr){
-				auto temp = new registerInterval();
+				auto temp = graph.new_registerInterval();
 				RegisterIntervals.push_back(temp);
 				(*s)->set_registerInterval(temp);
 				(*s)->clear_input_list();
+				temp->set_entry_live_list(liveness.live_in(*s));
+				set_entry(temp, *s);
+				temp->add_basic_block(*s);
 				WS.push(*s);
 			}
 		}
 	}
         
         /*At this point all register-interval are created
-         *      and the rest of the function just sets the register list of register-intervals
+         *      and the rest of the function just sets the series of instructions of register-intervals
          *      and forms the new CFG that its nodes are register-intervals*/
 
-        //This loop will set the register list of all register-intervals
 	for (auto i = RegisterIntervals.begin(); i != RegisterIntervals.end(); i++){
-                set<string> regList;//the register list of register-interval
-		regList.clear();
-		for (auto b = basic_blocks.begin(); b != basic_blocks.end(); b++){
-			if ((*b)->RegisterInterval() == *i){
-				auto s = (*b)->get_output_list();
-				for (auto it = s.begin(); it != s.end(); it++){
-					regList.insert(*it);
-				}
-			}
+		auto B = (*i)->get_basic_blocks();
+		sort(B.begin(), B.end(), comparePosition(block_position));//the instructions of a register-interval are in the order of basic_blocks
+
+		//This loop sets the series of instructions of the register-interval (the ranges of its basic blocks)
+		for (auto b = B.begin(); b != B.end(); b++){
+			(*i)->add_code((*b)->get_code());
 		}
-		(*i)->set_register_list(regList);
-	}
 
-	//This loop sets the series of instructions of all register-intervals
-	string code;
-	for (auto i = RegisterIntervals.begin(); i != RegisterIntervals.end(); i++){
-		code = "";
-		for (auto b = basic_blocks.begin(); b != basic_blocks.end(); b++){
-			if ((*b)->RegisterInterval() == *i){
-				code = code + (*b)->get_code();
+		//These loops set the predecessors and successors of the register-interval (each of them once)
+		neighbour_marks.next_epoch();
+		for (auto b = B.begin(); b != B.end(); b++){
+			auto P = (*b)->get_predecessors();
+			for (auto p = P.begin(); p != P.end(); p++){
+				if ((*p)->RegisterInterval() != *i && neighbour_marks.mark((*p)->RegisterInterval()->getID()))
+					(*i)->add_predecessor((*p)->RegisterInterval());
 			}
 		}
-		(*i)->set_code(code);
-	}
-
-	//This loop sets the predecessors and successors of all register-intervals
-	for (auto i = RegisterIntervals.begin(); i != RegisterIntervals.end(); i++){
-		for (auto b = basic_blocks.begin(); b != basic_blocks.end(); b++){
-			if ((*b)->RegisterInterval() == *i){
-				auto P = (*b)->get_predecessors();
-				for (auto p = P.begin(); p != P.end(); p++){
-					if ((*p)->RegisterInterval() != *i)
-						(*i)->add_predecessor((*p)->RegisterInterval());
-				}
-                                
-                                auto S = (*b)->get_successors();
-				for (auto s = S.begin(); s != S.end(); s++){
-					if ((*s)->RegisterInterval() != *i)
-						(*i)->add_successors((*s)->RegisterInterval());
-				}
+		neighbour_marks.next_epoch();
+		for (auto b = B.begin(); b != B.end(); b++){
+			auto S = (*b)->get_successors();
+			for (auto s = S.begin(); s != S.end(); s++){
+				if ((*s)->RegisterInterval() != *i && neighbour_marks.mark((*s)->RegisterInterval()->getID()))
+					(*i)->add_successors((*s)->RegisterInterval());
 			}
 		}
 	}
         
+	set_exit_live_lists(RegisterIntervals);
         return RegisterIntervals;
 }
 
 vector<registerInterval*> RegisterIntervalCreationPass::registerIntervalCreationPassTwo(vector<registerInterval*> RegisterInterval_in,int N){
 	vector<registerInterval*> RegisterInterval_out;//The registerInterval set that contains the reduced register-intervals
+	vector<vector<registerInterval*>> members;//For each output register-interval: the register-intervals that belong to it
 
         /*Initialization*/
 	for (auto i = RegisterInterval_in.begin(); i != RegisterInterval_in.end(); i++){
 		(*i)->set_next_level_registerInterval(nullptr);
 	}
 
-	queue<registerInterval*> WorkingSet; //The working set of registerInterval creation algorithm (pass 2)
+	int n = graph.number_of_registerIntervals(); //IDs of register-intervals are less than n
+	vector<int> interval_position(n, -1);//The position of each register-interval (by ID) in RegisterInterval_in
+	csrAdjacency interval_dependents;//For each register-interval (by ID): the register-intervals that have it as a predecessor
+	vector<pair<int, int>> edges; //(predecessor, register-interval)
+	for (int k = 0; k < RegisterInterval_in.size(); k++){
+		interval_position[RegisterInterval_in[k]->getID()] = k;
+		auto P = RegisterInterval_in[k]->get_predecessors();
+		for (auto p = P.begin(); p != P.end(); p++)
+			edges.push_back(make_pair((*p)->getID(), RegisterInterval_in[k]->getID()));
+	}
+	interval_dependents.build(n, edges);
+	vector<registerInterval*> level_of; //The register-interval of RegisterInterval_in that each basic block belongs to (by ID, only with loop admission)
+	if (loop_admission){
+		level_of.assign(graph.number_of_basicBlocks(), nullptr);
+		for (auto i = RegisterInterval_in.begin(); i != RegisterInterval_in.end(); i++){
+			auto& B = (*i)->get_basic_blocks();
+			for (auto b = B.begin(); b != B.end(); b++)
+				level_of[(*b)->getID()] = *i;
+		}
+	}
+
+	queue<pair<registerInterval*, int>> WorkingSet; //The working set of registerInterval creation algorithm (pass 2): a register-interval and the position of its next-level register-interval in RegisterInterval_out
 
-        
-	for(auto i = RegisterInterval_in.begin(); i != RegisterInterval_in.end(); i++){
-		auto Predecessors = (*i)->get_predecessors();
-		if(Predecessors.size() == 0){// each register-interval with no predecessors is assumed as an entry registerInterval
-			auto temp = new registerInterval();
-			RegisterInterval_out.push_back(temp);
-                        (*i)->set_next_level_registerInterval(temp);
-			WorkingSet.push(*i);//The register-interval is added to working set of the algorithm
+	if (weighted)
+		merge_hottest_first(RegisterInterval_in, N, interval_position, level_of, RegisterInterval_out, members); //the working set stays empty
+	else{
+		for(auto i = RegisterInterval_in.begin(); i != RegisterInterval_in.end(); i++){
+			auto Predecessors = (*i)->get_predecessors();
+			if(Predecessors.size() == 0){// each register-interval with no predecessors is assumed as an entry registerInterval
+				auto temp = graph.new_registerInterval();
+				RegisterInterval_out.push_back(temp);
+				members.push_back(vector<registerInterval*>());
+				(*i)->set_next_level_registerInterval(temp);
+				temp->set_entry_live_list((*i)->get_entry_live_list());
+				set_entry(temp, entry_block(*i));
+				WorkingSet.push(make_pair(*i, (int)RegisterInterval_out.size() - 1));//The register-interval is added to working set of the algorithm
+			}
 		}
 	}
 
 	while (!WorkingSet.empty()){
-		auto i = WorkingSet.front();//Get a register-interval form the working set
+		auto i = WorkingSet.front().first;//Get a register-interval form the working set
+		int j = WorkingSet.front().second;
 		WorkingSet.pop();
-		auto ii = i->nextLevelInterval();//ii is the current next-level register-interval that i belongs to 
-		if (i->get_register_list().size() < N){//Just register-intervals will be processed that contain less registers than the allowed number of registers
-			ii->set_register_list(i->get_register_list());//At the beginning the register list of the current next-level register registerInterval is equal to i
+		auto ii = i->nextLevelInterval();//ii is the current next-level register-interval that i belongs to (i is its entry)
+		members[j].push_back(i);
+		registerSet regList = i->get_register_list();//At the beginning the register list of the current next-level register registerInterval is equal to i
+		registerSet entry_live = ii->get_entry_live_list();
+		if (budget_size(i->get_register_list(), entry_live) < N){//Just register-intervals will be processed that contain less registers than the allowed number of registers
                         
-                        /*This loop looks at all register-interval as a candidate for adding to the current register-interval
-                                                            and checks the required conditions*/
-			for (auto Interval = RegisterInterval_in.begin(); Interval != RegisterInterval_in.end(); Interval++){
-				auto Predecessors = (*Interval)->get_predecessors();
-				bool C = true;//This boolean value will determine that all predecessors of the candidate register-interval belong to the current next-level register-interval
-                                set<string> Union;//This set will contain the union of register sets of all register-intervals that belong to the current next-level register-interval
-                                Union.clear();
+                        /* Only the frontier of ii (the register-intervals that have a predecessor in ii) are candidates. As in pass one, they are visited
+                           in the order of RegisterInterval_in and each of them at most once*/
+			priority_queue<pair<int, registerInterval*>, vector<pair<int, registerInterval*>>, greater<pair<int, registerInterval*>>> frontier;
+			frontier_marks.next_epoch();
+			for (auto d = interval_dependents.begin(i->getID()); d != interval_dependents.end(i->getID()); d++){
+				auto D = graph.register_interval(*d);
+				if (D->nextLevelInterval() == nullptr && frontier_marks.mark(*d))
+					frontier.push(make_pair(interval_position[*d], D));
+			}
+
+			while (!frontier.empty()){
+				int k = frontier.top().first;
+				auto Interval = frontier.top().second;
+				frontier.pop();
+				COUNT_EVENT(EVENT_ELIGIBILITY_CHECK);
 
-				visit_registerInterval_all_predecessors(*Interval);//All predecessors of the candidate register-interval in CFG will be marked
+				if (Interval->nextLevelInterval() != nullptr)//the register-interval should belong to no other next-level register-intervals
+					continue;
+
+				auto Predecessors = Interval->get_predecessors();
+				bool C = true;//This boolean value will determine that all predecessors of the candidate register-interval belong to the current next-level register-interval
 
                                 /*This loop will determine that all predecessors of the current register-interval belong to the current next-level register-interval*/
 				for(auto p = Predecessors.begin(); p != Predecessors.end(); p++){
+					COUNT_EVENT(EVENT_PREDECESSOR_VISIT);
 					if((*p)->nextLevelInterval() != ii)
-						if(*p != *Interval)
+						if(*p != Interval)
 							C = false;
 				}
 
-                                /*This loop will set the union set of registers of all register-intervals that the the candidate register-interval can be reached from
-                                                                        and also belong to the current next-level register registerInterval*/
-				for(auto iterator = RegisterInterval_in.begin(); iterator != RegisterInterval_in.end(); iterator++){
-					auto s = (*iterator)->get_register_list();
-					for (auto it = s.begin(); it != s.end(); it++){
-						Union.insert(*it);
+				if (!C && loop_admission && loops.header_loop(entry_block(Interval)) != -1){
+                                        /* As in pass one, the loop of the entry of the candidate can join ii as one unit: all register-intervals that contain
+                                           its basic blocks, if they are entered only from each other and from ii*/
+					auto& L = loops.loop_blocks(loops.header_loop(entry_block(Interval)));
+					vector<registerInterval*> unit;
+					bool admissible = true;
+					loop_marks.next_epoch();
+					for (auto x = L.begin(); x != L.end() && admissible; x++){
+						auto u = level_of[(*x)->getID()];
+						if (u == nullptr || u->nextLevelInterval() != nullptr)
+							admissible = false;
+						else if (loop_marks.mark(u->getID()))
+							unit.push_back(u);
+					}
+					registerSet unit_registers = regList;
+					for (auto u = unit.begin(); u != unit.end() && admissible; u++){
+						auto UP = (*u)->get_predecessors();
+						for (auto p = UP.begin(); p != UP.end(); p++){
+							if (!loop_marks.marked((*p)->getID()) && (*p)->nextLevelInterval() != ii)
+								admissible = false;
+						}
+						unit_registers.insert((*u)->get_register_list());
+					}
+					if (!admissible || budget_size(unit_registers, entry_live) >= N)
+						continue;
+
+					regList = unit_registers;
+					for (auto u = unit.begin(); u != unit.end(); u++){
+						(*u)->set_next_level_registerInterval(ii);
+						members[j].push_back(*u);
 					}
+					//the register-intervals that depend on the unit (the exits of the loop) join the frontier
+					for (auto u = unit.begin(); u != unit.end(); u++){
+						for (auto d = interval_dependents.begin((*u)->getID()); d != interval_dependents.end((*u)->getID()); d++){
+							auto D = graph.register_interval(*d);
+							if (D->nextLevelInterval() == nullptr && frontier_marks.mark(*d))
+								frontier.push(make_pair(interval_position[*d], D));
+						}
+					}
+					continue;
 				}
 
                                 /*At this point we add the candidate register-interval to the current register-interval if all required conditions are satisfied*/
-				if ((*Interval)->nextLevelInterval() == nullptr //the register-interval should belong to no other next-level register-intervals
-                                        && C //the register-interval can be reached from the current next-level register-interval
-                                        && Union.size() < N //the size of the union set should not be more than the allowed number of registers in each register-interval
+				if (C //the register-interval can be reached from the current next-level register-interval
+                                        && budget_union_size(regList, Interval->get_register_list(), entry_live) < N //the size of the union set should not be more than the allowed number of registers in each register-interval
                                         )
                                 {
-					(*Interval)->set_next_level_registerInterval(ii);
-					auto s = (*Interval)->get_register_list();
-					Union = ii->get_register_list();
-					for (auto it = s.begin(); it != s.end(); ++it){
-						Union.insert(*it);
+					Interval->set_next_level_registerInterval(ii);
+					regList.insert(Interval->get_register_list());
+					members[j].push_back(Interval);
+
+					//the register-intervals that depend on the candidate join the frontier
+					for (auto d = interval_dependents.begin(Interval->getID()); d != interval_dependents.end(Interval->getID()); d++){
+						auto D = graph.register_interval(*d);
+						if (D->nextLevelInterval() == nullptr && interval_position[*d] > k && frontier_marks.mark(*d))
+							frontier.push(make_pair(interval_position[*d], D));
 					}
-					ii->set_register_list(Union);
 				}
 			}
 		}
+		ii->set_register_list(regList);
                 /*At this point no more register-intervals can be added to the current next-level register-interval*/
                 
-		set<registerInterval*> Successors;//This set will contain the successors the current next-level register-interval
-		Successors.clear();
+		vector<registerInterval*> Successors;//This set will contain the successors the current next-level register-interval (each of them once and in the order of IDs)
                 /*This loop determines the members of Successors set*/
-		for (auto Interval = RegisterInterval_in.begin(); Interval != RegisterInterval_in.end(); Interval++){
-			if ((*Interval)->nextLevelInterval() == ii){
-				auto S = (*Interval)->get_successors();
-				for (auto s = S.begin(); s != S.end(); s++){
-					Successors.insert(*s);
-				}
+		successor_marks.next_epoch();
+		for (auto Interval = members[j].begin(); Interval != members[j].end(); Interval++){
+			auto S = (*Interval)->get_successors();
+			for (auto s = S.begin(); s != S.end(); s++){
+				if ((*s)->nextLevelInterval() == nullptr && successor_marks.mark((*s)->getID()))
+					Successors.push_back(*s);
 			}
 		}
+		sort(Successors.begin(), Successors.end(), compareID());
                 
                 /*This loop will assign  new register-intervals to all successors of the current next-level registerInterval (as their next-level register registerIntervals)*/
 		for (auto s = Successors.begin(); s != Successors.end(); s++){
-			if ((*s)->nextLevelInterval() == nullptr){
-				auto temp = new registerInterval();
-				RegisterInterval_out.push_back(temp);
-				(*s)->set_next_level_registerInterval(temp);
-				WorkingSet.push(*s);
-			}
+			auto temp = graph.new_registerInterval();
+			RegisterInterval_out.push_back(temp);
+			members.push_back(vector<registerInterval*>());
+			(*s)->set_next_level_registerInterval(temp);
+			temp->set_entry_live_list((*s)->get_entry_live_list());
+			set_entry(temp, entry_block(*s));
+			WorkingSet.push(make_pair(*s, (int)RegisterInterval_out.size() - 1));
 		}
 	}
         /*At this point all register-intervals of the next level are created
-                    and rest of the function sets the register lists and the forms the new CFG*/
-
-	/*this loop sets the register list of all output register-intervals*/
-	for (auto Interval = RegisterInterval_out.begin(); Interval != RegisterInterval_out.end(); Interval++){
-		set<string> regList;
-            	regList.clear();
-		for (auto iterator = RegisterInterval_in.begin(); iterator != RegisterInterval_in.end(); iterator++){
-			if ((*iterator)->nextLevelInterval() == *Interval){
-				auto R = (*iterator)->get_register_list();
-				for (auto it = R.begin(); it != R.end(); it++){
-					regList.insert(*it);
-				}
+                    and rest of the function sets the series of instructions and forms the new CFG*/
+
+	for (int j = 0; j < RegisterInterval_out.size(); j++){
+		auto Interval = RegisterInterval_out[j];
+		auto M = members[j];
+		sort(M.begin(), M.end(), [&](registerInterval* a, registerInterval* b){ return interval_position[a->getID()] < interval_position[b->getID()]; });//the instructions are in the order of RegisterInterval_in
+
+		//This loop sets the series of instructions and the basic blocks of the output register-interval
+		for (auto m = M.begin(); m != M.end(); m++){
+			Interval->add_code((*m)->get_code());
+			auto& B = (*m)->get_basic_blocks();
+			for (auto b = B.begin(); b != B.end(); b++)
+				Interval->add_basic_block(*b);
+		}
+
+		//These loops set the predecessors and successors of the output register-interval (each of them once)
+		neighbour_marks.next_epoch();
+		for (auto m = M.begin(); m != M.end(); m++){
+			auto Predecessors = (*m)->get_predecessors();
+			for (auto p = Predecessors.begin(); p != Predecessors.end(); p++){
+				if ((*p)->nextLevelInterval() != Interval && neighbour_marks.mark((*p)->nextLevelInterval()->getID()))
+					Interval->add_predecessor((*p)->nextLevelInterval());
+			}
+		}
+		neighbour_marks.next_epoch();
+		for (auto m = M.begin(); m != M.end(); m++){
+			auto Successors = (*m)->get_successors();
+			for (auto s = Successors.begin(); s != Successors.end(); s++){
+				if ((*s)->nextLevelInterval() != Interval && neighbour_marks.mark((*s)->nextLevelInterval()->getID()))
+					Interval->add_successors((*s)->nextLevelInterval());
 			}
 		}
-		(*Interval)->set_register_list(regList);
 	}
 
-	/*this loop sets the series of instructions in all output register-intervals*/
-	string code;
-	for (auto Interval = RegisterInterval_out.begin(); Interval != RegisterInterval_out.end(); Interval++){
-		code = "";
-		for (auto iterator = RegisterInterval_in.begin(); iterator != RegisterInterval_in.end(); iterator++){
-			if ((*iterator)->nextLevelInterval() == *Interval){
-				code = code + (*iterator)->get_code();
-			}
+	set_exit_live_lists(RegisterInterval_out);
+	return RegisterInterval_out;
+}
+
+void RegisterIntervalCreationPass::merge_hottest_first(const vector<registerInterval*>& RegisterInterval_in, int N, const vector<int>& interval_position,
+                                                       const vector<registerInterval*>& level_of, vector<registerInterval*>& RegisterInterval_out,
+                                                       vector<vector<registerInterval*>>& members){
+	int m = RegisterInterval_in.size();
+	vector<int> group(m); //For each register-interval (by position): a register-interval of its group, the entry of the group if it is itself
+	vector<registerSet> group_registers(m); //For the entry of each group (by position): the registers of the group
+	vector<int> group_size(m, 1); //For the entry of each group (by position): the number of register-intervals of the group
+	for (int k = 0; k < m; k++){
+		group[k] = k;
+		group_registers[k] = RegisterInterval_in[k]->get_register_list();
+	}
+	auto entry_of = [&group](int k){ //the entry of the group of k (the path is shortened on the way)
+		while (group[k] != k){
+			group[k] = group[group[k]];
+			k = group[k];
 		}
-		(*Interval)->set_code(code);
+		return k;
+	};
+
+        /* The register-intervals are visited hottest entry first (and then in the order of RegisterInterval_in). A register-interval that is
+           still the entry of its group when it is visited (it is not if its loop has joined a group as a unit) joins with its group the group
+           of its predecessors if they all belong to one group (or to its own) and the registers of both groups fit, so every group is single-entry*/
+	vector<pair<double, int>> order; //(frequency of the entry negated, position)
+	for (int k = 0; k < m; k++){
+		if (RegisterInterval_in[k]->get_predecessors().size() != 0)
+			order.push_back(make_pair(-entry_frequency(RegisterInterval_in[k]), k));
 	}
+	sort(order.begin(), order.end());
+	for (auto o = order.begin(); o != order.end(); o++){
+		int x = o->second;
+		if (entry_of(x) != x) //x has joined a group with the loop of a hotter register-interval
+			continue;
+		COUNT_EVENT(EVENT_ELIGIBILITY_CHECK);
+		int g = -1; //the group of the predecessors
+		bool C = true;
+		auto Predecessors = RegisterInterval_in[x]->get_predecessors();
+		for (auto p = Predecessors.begin(); p != Predecessors.end() && C; p++){
+			COUNT_EVENT(EVENT_PREDECESSOR_VISIT);
+			int e = entry_of(interval_position[(*p)->getID()]);
+			if (e == x)
+				continue;
+			if (g == -1)
+				g = e;
+			else if (e != g)
+				C = false;
+		}
 
-	/*this loop sets the predecessors and successors of all output register-intervals*/
-	for (auto Interval = RegisterInterval_out.begin(); Interval != RegisterInterval_out.end(); Interval++){
-		for (auto iterator = RegisterInterval_in.begin(); iterator != RegisterInterval_in.end(); iterator++){
-			if ((*iterator)->nextLevelInterval() == *Interval){
-				auto Predecessors = (*iterator)->get_predecessors();
-                                for (auto p = Predecessors.begin(); p != Predecessors.end(); p++){
-					if ((*p)->nextLevelInterval() != *Interval)
-						(*Interval)->add_successors((*p)->nextLevelInterval());
+		if (!C && loop_admission && loops.header_loop(entry_block(RegisterInterval_in[x])) != -1){
+                        /* As in the frontier merge, the loop of the entry of x can join a group as one unit: the groups of the register-intervals
+                           that contain its basic blocks, if these groups hold nothing else and the unit is entered only from that one group*/
+			auto& L = loops.loop_blocks(loops.header_loop(entry_block(RegisterInterval_in[x])));
+			vector<int> unit; //the positions of the register-intervals of the loop
+			vector<int> entries; //the entries of their groups
+			bool admissible = true;
+			loop_marks.next_epoch();
+			for (auto b = L.begin(); b != L.end() && admissible; b++){
+				auto u = level_of[(*b)->getID()];
+				if (u == nullptr)
+					admissible = false;
+				else if (loop_marks.mark(u->getID()))
+					unit.push_back(interval_position[u->getID()]);
+			}
+			int size = 0;
+			for (auto u = unit.begin(); u != unit.end() && admissible; u++){
+				int e = entry_of(*u);
+				if (!loop_marks.marked(RegisterInterval_in[e]->getID()))
+					admissible = false; //a part of the loop belongs to the group of a register-interval outside it
+				else if (e == *u){
+					entries.push_back(e);
+					size += group_size[e];
 				}
-                                
-				auto Successors = (*iterator)->get_successors();
-				for (auto s = Successors.begin(); s != Successors.end(); s++){
-					if ((*s)->nextLevelInterval() != *Interval){
-						(*Interval)->add_predecessor((*s)->nextLevelInterval());
-					}
+			}
+			g = -1;
+			for (auto u = unit.begin(); u != unit.end() && admissible; u++){
+				auto UP = RegisterInterval_in[*u]->get_predecessors();
+				for (auto p = UP.begin(); p != UP.end() && admissible; p++){
+					COUNT_EVENT(EVENT_PREDECESSOR_VISIT);
+					if (loop_marks.marked((*p)->getID()))
+						continue;
+					int e = entry_of(interval_position[(*p)->getID()]);
+					if (g == -1)
+						g = e;
+					else if (e != g)
+						admissible = false;
 				}
 			}
+			if (!admissible || size != (int)unit.size() || g == -1)
+				continue;
+			registerSet unit_registers = group_registers[g];
+			for (auto e = entries.begin(); e != entries.end(); e++)
+				unit_registers.insert(group_registers[*e]);
+			if (budget_size(unit_registers, RegisterInterval_in[g]->get_entry_live_list()) >= N)
+				continue;
+			for (auto e = entries.begin(); e != entries.end(); e++){
+				group[*e] = g;
+				group_size[g] += group_size[*e];
+			}
+			group_registers[g] = unit_registers;
+			continue;
 		}
+
+		if (!C || g == -1 || budget_union_size(group_registers[g], group_registers[x], RegisterInterval_in[g]->get_entry_live_list()) >= N)
+			continue;
+		group[x] = g;
+		group_size[g] += group_size[x];
+		group_registers[g].insert(group_registers[x]);
 	}
 
-	return RegisterInterval_out;
+	//one next-level register-interval for each group, in the order of their entries
+	vector<int> output_of(m, -1); //For the entry of each group (by position): its position in RegisterInterval_out
+	for (int k = 0; k < m; k++){
+		int e = entry_of(k);
+		if (output_of[e] == -1){
+			auto temp = graph.new_registerInterval();
+			temp->set_entry_live_list(RegisterInterval_in[e]->get_entry_live_list());
+			temp->set_register_list(group_registers[e]);
+			set_entry(temp, entry_block(RegisterInterval_in[e]));
+			output_of[e] = RegisterInterval_out.size();
+			RegisterInterval_out.push_back(temp);
+			members.push_back(vector<registerInterval*>());
+		}
+		RegisterInterval_in[k]->set_next_level_registerInterval(RegisterInterval_out[output_of[e]]);
+		members[output_of[e]].push_back(RegisterInterval_in[k]);
+	}
+}
+
+void RegisterIntervalCreationPass::set_exit_live_lists(const vector<registerInterval*>& intervals){
+	for (auto i = intervals.begin(); i != intervals.end(); i++){
+		auto& B = (*i)->get_basic_blocks();
+		member_marks.next_epoch();
+		for (auto b = B.begin(); b != B.end(); b++)
+			member_marks.mark((*b)->getID());
+
+		registerSet exit_live; //a basic block with no successors ends the kernel (EXIT), so nothing is live after it
+		for (auto b = B.begin(); b != B.end(); b++){
+			for (int k = (*b)->first_instruction(); k < (*b)->last_instruction(); k++){
+				if (livenessAnalysis::leaves_function(graph.get_instruction(k)))
+					exit_live = livenessAnalysis::all_registers(); //a call or a return: the callee or the caller may read any register
+			}
+			auto S = (*b)->get_successors();
+			for (auto s = S.begin(); s != S.end(); s++){
+				if (!member_marks.marked((*s)->getID()))
+					exit_live.insert(liveness.live_in(*s));
+			}
+		}
+		(*i)->set_exit_live_list(exit_live);
+	}
 }
 
 void RegisterIntervalCreationPass::traverse(basicBlock* BB, int N){
-	set<string> temp_list;
-	vector<basicBlock*> V;
 	auto register_list = BB->get_input_list();
+	registerSet entry_live = BB->RegisterInterval()->get_entry_live_list(); //the live registers on entry to the register-interval of BB
+	if (split_planning){
+		split_at(BB, plan_splits(BB, N, entry_live));
+		return;
+	}
 
 	basicBlock* BB1;
-	registerInterval* temp;
         string new_name, old_name;
         
-        //set<string> register_list;//register_list is a list that will be updated after processing each instruction and the new registers will be added to it
-        //register_list.clear();
-        set<string> temporary_register_list;//temporary_register_list contains is like register_list but it can have more than N registers and it is checked at each iteration
-        temporary_register_list.clear();
+        registerSet temporary_register_list;//temporary_register_list contains is like register_list but it can have more than N registers and it is checked at each iteration
         
-        string code = BB->get_code();//code is the string of instruction sequence
+        codeRange code = BB->get_code();//code is the range of instruction sequence
+	int first = BB->first_instruction();
+	int last = BB->last_instruction();
         
-	int found1 = 0; //points to the beginning of the instruction string
-	int found2 = code.find(";", found1, 1); //points to the end of instructions string
-	while (found2 != string::npos){//This loop continues until all instructions of the basic block are processed
+	for (int k = first; k < last; k++){//This loop continues until all (decoded) instructions of the basic block are processed
 		
-                /* this loop updates register_list for the current instruction (in other words it finds the register operands of the instruction)*/
-		for (int i = found1; i < found2; i++){
-			if (code[i] == 'R'){
-				string str = "";
-				if (code[i + 1]>47 && code[i + 1] < 58){
-					str.push_back('R');
-					str.push_back(code[i + 1]);
-					if (code[i + 2]>47 && code[i + 2] < 58){
-						str.push_back(code[i + 2]);
-					}
-					temporary_register_list.insert(str);
-				}
-			}
-		}
+                /* register_list is updated with the registers of the current instruction*/
+		temporary_register_list.insert(graph.get_instruction(k).registers());
 
 		/*after cheching the size of temporary_register_list, we decide to split the basic block or not */
-		if (temporary_register_list.size() > N){
+		if (budget_size(temporary_register_list, entry_live) > N){
                         /*At this point the basic block will be splited and the current instruction will reside in the second baisc basicBlock*/
-			string code1, code2;//code1 and code2 contain the instructions of two basic blocks after splitting
-                        code1.append(code, 0, found1); 
-			code2.append(code, found1 + 1, code.size() - found1);
+			COUNT_EVENT(EVENT_SPLIT);
+			size_t found1 = 0; //points to the beginning of the current instruction in code (after the ";" of the previous one)
+			for (int j = first; j < k; j++)
+				found1 = code.find(";", found1) + 1;
+			codeRange code1 = code.sub(0, found1);//code1 and code2 contain the instructions of two basic blocks after splitting
+			codeRange code2 = code.sub(found1 + 1);
 
 
 			//introducing a new basic block BB1:
-			BB1 = new basicBlock();
+			BB1 = graph.new_basicBlock(BB->get_ABB());//IDs of new basic blocks continue after the regular basic blocks
 			basic_blocks.push_back(BB1);
 			
 			old_name = BB->get_name();
@@ -373,30 +771,27 @@ void RegisterIntervalCreationPass::traverse(basicBlock* BB, int N){
 			
                         int found = 0;
 			found = code2.find(old_name, found+1);
-			while(found != string::npos){//in thils loop finds points of code that uses the old name and replaces with the new name
-				code2.replace(found, old_name.size(), new_name);
+			if(found != string::npos){//the code that uses the old name is renamed, so it is no longer a range of the input and the graph keeps the new text
+				string text = code2.str();
+				while(found != string::npos){//in thils loop finds points of code that uses the old name and replaces with the new name
+					text.replace(found, old_name.size(), new_name);
 				
-				found = code2.find(old_name, found+1);
+					found = text.find(old_name, found+1);
+				}
+				code2 = graph.keep_text(text);
 			}
 			BB1->set_code(code2);
+			BB1->set_instructions(k, last);
 
 			/*At this point the register set of the new basic block will be set*/
-			found = 0;
-			found = code2.find("R", found + 1, 1);
-			while (found != string::npos){
-				string str = "R";
-				if (code2[found + 1] > 47 && code2[found + 1] < 58){
-					for (int j = found + 1; code2[j] >47 && code2[j] < 58; j++){
-						str = str + code2[j];
-					}
-					BB1->add_register(str);
-				}
-
-				found = code2.find("R", found + 1, 1);
-			}
+			registerSet registers;
+			for (int j = k; j < last; j++)
+				registers.insert(graph.get_instruction(j).registers());
+			BB1->set_output_list(registers);
                         
                         //The BB will be splitted and its code and register list are updated
 			BB->set_code(code1);
+			BB->set_instructions(first, k);
 			BB->set_output_list(register_list);
 
 			/*setting successors of old and new basic blocks*/
@@ -408,12 +803,23 @@ void RegisterIntervalCreationPass::traverse(basicBlock* BB, int N){
 
 			/*setting predecessors of new and old basic blocks*/
 			BB1->add_predecessor(BB); //the only predecessor of the new basic block is the old one (also the predecessors of the old basic block won't change)
+			dominators.add_leaf(BB1, BB);
+			liveness.split(BB, BB1, graph);
+			loops.split(BB, BB1);
+			if (weighted)
+				frequencies.split(BB, BB1);
+			reaching_registers.resize(BB1->getID() + 1);
+			block_position.resize(BB1->getID() + 1, -1);
+			block_position[BB1->getID()] = basic_blocks.size() - 1;
 			
 
-			auto temp = new registerInterval();
+			auto temp = graph.new_registerInterval();
 			RegisterIntervals.push_back(temp);
 			BB1->set_registerInterval(temp);
 			BB1->clear_input_list();
+			temp->set_entry_live_list(liveness.live_in(BB1));
+			set_entry(temp, BB1);
+			temp->add_basic_block(BB1);
 			WS.push(BB1);//the new basic block has been assigned to a new register-interval
 
 			return;
@@ -424,49 +830,163 @@ void RegisterIntervalCreationPass::traverse(basicBlock* BB, int N){
 		}
 
 		register_list = temporary_register_list;
-		found1 = found2 + 1;
-		found2 = code.find(";", found1, 1);
 	}
 
 	return;
 }
 
-void RegisterIntervalCreationPass::visit_all_predecessors(basicBlock* BB){
-	for(int i=0; i < basic_blocks.size(); i++)
-		mark.push_back(false);
+vector<int> RegisterIntervalCreationPass::plan_splits(basicBlock* BB, int N, const registerSet& entry_live){
+	int first = BB->first_instruction();
+	int last = BB->last_instruction();
+	int n = last - first;
+	registerSet block_registers;
+	for (int k = first; k < last; k++)
+		block_registers.insert(graph.get_instruction(k).registers());
+	if (budget_size(block_registers, entry_live) <= N)
+		return vector<int>(); //the basic block fits
+
+        /* Backward: the longest part that starts at each instruction ends where the (N+1)-th of its counted registers first occurs
+           (the registers of the part are the registers whose next occurrence is in it), and the live registers before each instruction
+           are the entry live registers of a part that starts there*/
+	vector<int> reach(n);         //the end of the longest part that starts at each instruction (relative to first)
+	vector<int> live_size(n);     //the number of live registers before each instruction
+	vector<int> next(registerSet::MAX_REGISTERS, n); //the next occurrence of each register (relative to first, n if none)
+	vector<int> registers;        //the registers of the instructions after the current one
+	vector<int> occurrences;
+	registerSet live = liveness.live_out(BB);
+	for (int k = n - 1; k >= 0; k--){
+		registerSet R = graph.get_instruction(first + k).registers();
+		for (int r = 0; r < registerSet::MAX_REGISTERS; r++){
+			if (R.contains(r)){
+				if (next[r] == n)
+					registers.push_back(r);
+				next[r] = k;
+			}
+		}
+		live = livenessAnalysis::transfer(graph, first + k, first + k + 1, live);
+		live_size[k] = live.size();
+
+		const registerSet& counted = k == 0 ? entry_live : live;
+		occurrences.clear();
+		for (auto r = registers.begin(); r != registers.end(); r++){
+			if (budget != BUDGET_LIVE_IN || counted.contains(*r))
+				occurrences.push_back(next[*r]);
+		}
+		if ((int)occurrences.size() <= N)
+			reach[k] = n;
+		else{
+			nth_element(occurrences.begin(), occurrences.begin() + N, occurrences.end());
+			reach[k] = max(occurrences[N], k + 1); //a part has at least one instruction
+		}
+	}
 
-	for(int i=0;i<basic_blocks.size(); i++){
-		mark[i] = false;
+        /* Forward: the fewest parts that end at each instruction, and among them the fewest registers live at the split points. A part can
+           end at p if it starts at a split point whose reach is at least p, so the split points are kept in a heap by their cost and those
+           that can not reach p are dropped (they can not reach any later instruction either)*/
+	typedef pair<pair<int, int>, int> splitPoint; //((parts, live registers at the split points), instruction)
+	vector<pair<int, int>> cost(n + 1);
+	vector<int> previous(n + 1);
+	priority_queue<splitPoint, vector<splitPoint>, greater<splitPoint>> starts;
+	cost[0] = make_pair(0, 0);
+	for (int p = 1; p <= n; p++){
+		starts.push(make_pair(cost[p - 1], p - 1));
+		while (reach[starts.top().second] < p)
+			starts.pop();
+		cost[p] = make_pair(starts.top().first.first + 1, starts.top().first.second + (p < n ? live_size[p] : 0));
+		previous[p] = starts.top().second;
 	}
 
-	visit_predecessors(BB);
+	vector<int> cuts;
+	for (int p = previous[n]; p != 0; p = previous[p])
+		cuts.push_back(first + p);
+	reverse(cuts.begin(), cuts.end());
+	return cuts;
 }
 
-void RegisterIntervalCreationPass::visit_predecessors(basicBlock* BB){
-	mark[BB->getID()] = true;
-	auto P = BB->get_predecessors();
-	for(int i=0;i<P.size();i++){
-		if(!mark[P[i]->getID()])
-			visit_predecessors(P[i]);
+void RegisterIntervalCreationPass::split_at(basicBlock* BB, const vector<int>& cuts){
+	int first = BB->first_instruction();
+	int last = BB->last_instruction();
+	codeRange code = BB->get_code();
+	string old_name = BB->get_name();
+
+	/*the offset of each split point in code (after the ";" of the instruction before it)*/
+	vector<size_t> offsets;
+	size_t found1 = 0;
+	int k = first;
+	for (auto c = cuts.begin(); c != cuts.end(); c++){
+		for (; k < *c; k++)
+			found1 = code.find(";", found1) + 1;
+		offsets.push_back(found1);
 	}
-}
 
-void RegisterIntervalCreationPass::visit_registerInterval_all_predecessors(registerInterval* in){
-	for(int j=0; j < RegisterIntervals[0]->getID() + RegisterIntervals.size(); j++)
-		registerInterval_mark.push_back(false);
-
-	for(int i=0; i < RegisterIntervals[0]->getID() + RegisterIntervals.size(); i++){
-		registerInterval_mark[i] = false;
+	vector<basicBlock*> parts(1, BB); //BB and the new basic blocks after it
+	auto successors = BB->get_successors();
+	for (int j = 0; j < cuts.size(); j++){
+		COUNT_EVENT(EVENT_SPLIT);
+		int end = j + 1 < cuts.size() ? cuts[j + 1] : last;
+		codeRange code2 = j + 1 < cuts.size() ? code.sub(offsets[j] + 1, offsets[j + 1] - offsets[j] - 1) : code.sub(offsets[j] + 1);
+
+		basicBlock* previous = parts.back();
+		basicBlock* BB1 = graph.new_basicBlock(BB->get_ABB());
+		basic_blocks.push_back(BB1);
+		string new_name = old_name + std::to_string(previous->getID() + 1); //not the name of previous, so the names do not grow along the chain
+		BB1->set_name(new_name);
+
+		size_t found = code2.find(old_name, 1);
+		if (found != string::npos){//the code that uses the old name is renamed, so it is no longer a range of the input and the graph keeps the new text
+			string text = code2.str();
+			while (found != string::npos){
+				text.replace(found, old_name.size(), new_name);
+				found = text.find(old_name, found + 1);
+			}
+			code2 = graph.keep_text(text);
+		}
+		BB1->set_code(code2);
+		BB1->set_instructions(cuts[j], end);
+
+		registerSet registers;
+		for (int i = cuts[j]; i < end; i++)
+			registers.insert(graph.get_instruction(i).registers());
+		BB1->set_output_list(registers);
+
+		if (j + 1 == cuts.size())
+			BB1->set_successors(successors); //the last part has the successors of the original basic block
+		previous->set_successors(vector<basicBlock*>(1, BB1));
+		BB1->add_predecessor(previous); //the predecessors of the successors of the original basic block won't change
+		dominators.add_leaf(BB1, previous);
+		loops.split(previous, BB1);
+		if (weighted)
+			frequencies.split(previous, BB1);
+		reaching_registers.resize(BB1->getID() + 1);
+		block_position.resize(BB1->getID() + 1, -1);
+		block_position[BB1->getID()] = basic_blocks.size() - 1;
+		parts.push_back(BB1);
 	}
 
-	registerInterval_visit_predecessors(in);
-}
-
-void RegisterIntervalCreationPass::registerInterval_visit_predecessors(registerInterval* in){
-	registerInterval_mark[in->getID()] = true;
-	auto P = in->get_predecessors();
-	for(int i=0;i<P.size();i++){
-		if(!registerInterval_mark[P[i]->getID()])
-			registerInterval_visit_predecessors(P[i]);
+	//The first part stays in the register-interval of BB
+	int end = cuts.size() != 0 ? cuts[0] : last;
+	if (cuts.size() != 0){
+		BB->set_code(code.sub(0, offsets[0]));
+		BB->set_instructions(first, end);
+	}
+	if (end > first){
+		registerSet registers;
+		for (int i = first; i < end; i++)
+			registers.insert(graph.get_instruction(i).registers());
+		BB->set_output_list(registers);
+	}
+	if (cuts.size() == 0)
+		return;
+
+	liveness.split(parts, graph);
+	for (auto p = parts.begin() + 1; p != parts.end(); p++){
+		auto temp = graph.new_registerInterval();
+		RegisterIntervals.push_back(temp);
+		(*p)->set_registerInterval(temp);
+		(*p)->clear_input_list();
+		temp->set_entry_live_list(liveness.live_in(*p));
+		set_entry(temp, *p);
+		temp->add_basic_block(*p);
+		WS.push(*p);//each new basic block has been assigned to a new register-interval
 	}
 }
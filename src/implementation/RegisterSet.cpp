@@ -0,0 +1,129 @@
+/*
+ * \file    RegisterSet.cpp
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Implementation of the register set
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#include "../interface/RegisterSet.h"
+
+using namespace std;
+
+registerSet::registerSet(){
+	clear();
+}
+
+void registerSet::insert(int r){
+	if (r >= 0 && r < MAX_REGISTERS)
+		words[r >> 6] |= uint64_t(1) << (r & 63);
+}
+
+void registerSet::insert(const registerSet& s){
+	COUNT_EVENT(EVENT_SET_INSERT);
+	for (int i = 0; i < WORDS; i++)
+		words[i] |= s.words[i];
+}
+
+void registerSet::remove(const registerSet& s){
+	for (int i = 0; i < WORDS; i++)
+		words[i] &= ~s.words[i];
+}
+
+void registerSet::intersect(const registerSet& s){
+	for (int i = 0; i < WORDS; i++)
+		words[i] &= s.words[i];
+}
+
+void registerSet::insert_operands(const char* begin, const char* end){
+	for (const char* c = begin; c < end; c++){
+		if (*c == 'R' && c + 1 < end && c[1] >= '0' && c[1] <= '9'){
+			int r = 0;
+			for (c++; c < end && *c >= '0' && *c <= '9'; c++){
+				if (r < MAX_REGISTERS)
+					r = r * 10 + (*c - '0');
+			}
+			insert(r);
+			c--;
+		}
+	}
+}
+
+void registerSet::clear(){
+	for (int i = 0; i < WORDS; i++)
+		words[i] = 0;
+}
+
+int registerSet::size() const{
+	int n = 0;
+	for (int i = 0; i < WORDS; i++)
+		n += __builtin_popcountll(words[i]);
+	return n;
+}
+
+int registerSet::union_size(const registerSet& s) const{
+	int n = 0;
+	for (int i = 0; i < WORDS; i++)
+		n += __builtin_popcountll(words[i] | s.words[i]);
+	return n;
+}
+
+int registerSet::intersection_size(const registerSet& s) const{
+	int n = 0;
+	for (int i = 0; i < WORDS; i++)
+		n += __builtin_popcountll(words[i] & s.words[i]);
+	return n;
+}
+
+bool registerSet::contains(int r) const{
+	if (r < 0 || r >= MAX_REGISTERS)
+		return false;
+	return (words[r >> 6] >> (r & 63)) & 1;
+}
+
+bool registerSet::empty() const{
+	uint64_t any = 0;
+	for (int i = 0; i < WORDS; i++)
+		any |= words[i];
+	return any == 0;
+}
+
+bool registerSet::operator==(const registerSet& s) const{
+	for (int i = 0; i < WORDS; i++){
+		if (words[i] != s.words[i])
+			return false;
+	}
+	return true;
+}
+
+bool registerSet::operator!=(const registerSet& s) const{
+	return !(*this == s);
+}
+
+set<string> registerSet::names() const{
+	set<string> s;
+	for (int i = 0; i < WORDS; i++){
+		uint64_t w = words[i];
+		while (w != 0){
+			int b = __builtin_ctzll(w);
+			s.insert("R" + to_string(i * 64 + b));
+			w &= w - 1;
+		}
+	}
+	return s;
+}
+
+string registerSet::bitmask() const{
+	static const char digits[] = "0123456789abcdef";
+	string mask;
+	for (int i = WORDS * 16 - 1; i >= 0; i--){
+		int d = (words[i / 16] >> ((i % 16) * 4)) & 15;
+		if (d != 0 || mask.size() != 0 || i == 0)
+			mask += digits[d];
+	}
+	return "0x" + mask;
+}
@@ -0,0 +1,118 @@
+/*
+ * \file    ResultWriter.cpp
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Implementation of the buffered writer of the output logs
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#include "../interface/ResultWriter.h"
+
+using namespace std;
+
+resultWriter::resultWriter(){
+	file = nullptr;
+}
+
+resultWriter::resultWriter(const string& path){
+	file = fopen(path.c_str(), "wb");
+	if (file != nullptr)
+		buffer.reserve(CAPACITY + 4096);
+}
+
+resultWriter::~resultWriter(){
+	close();
+}
+
+void resultWriter::close(){
+	if (file == nullptr)
+		return;
+	write_buffer();
+	fclose(file);
+	file = nullptr;
+}
+
+bool resultWriter::is_open() const{
+	return file != nullptr;
+}
+
+void resultWriter::write_buffer(){
+	if (file != nullptr && buffer.size() != 0)
+		fwrite(buffer.data(), 1, buffer.size(), file);
+	buffer.clear();
+}
+
+resultWriter& resultWriter::operator<<(const string& s){
+	buffer += s;
+	if (buffer.size() > CAPACITY)
+		write_buffer();
+	return *this;
+}
+
+resultWriter& resultWriter::operator<<(const char* s){
+	buffer += s;
+	if (buffer.size() > CAPACITY)
+		write_buffer();
+	return *this;
+}
+
+resultWriter& resultWriter::operator<<(char c){
+	buffer += c;
+	if (buffer.size() > CAPACITY)
+		write_buffer();
+	return *this;
+}
+
+resultWriter& resultWriter::operator<<(int x){
+	return *this << (long long)x;
+}
+
+resultWriter& resultWriter::operator<<(size_t x){
+	char digits[24];
+	snprintf(digits, sizeof(digits), "%zu", x);
+	return *this << (const char*)digits;
+}
+
+resultWriter& resultWriter::operator<<(long long x){
+	char digits[24];
+	snprintf(digits, sizeof(digits), "%lld", x);
+	return *this << (const char*)digits;
+}
+
+void resultWriter::json_string(const string& s){
+	static const char digits[] = "0123456789abcdef";
+	buffer += '"';
+	for (int i = 0; i < s.size(); i++){
+		unsigned char c = s[i];
+		if (c == '"' || c == '\\'){
+			buffer += '\\';
+			buffer += c;
+		}
+		else if (c < 0x20){
+			buffer += "\\u00";
+			buffer += digits[c >> 4];
+			buffer += digits[c & 15];
+		}
+		else
+			buffer += c;
+	}
+	*this << '"';
+}
+
+void resultWriter::csv_field(const string& s){
+	if (s.find_first_of(",\"\r\n") == string::npos){
+		*this << s;
+		return;
+	}
+	buffer += '"';
+	for (int i = 0; i < s.size(); i++){
+		if (s[i] == '"')
+			buffer += '"';
+		buffer += s[i];
+	}
+	*this << '"';
+}
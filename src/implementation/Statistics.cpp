@@ -0,0 +1,163 @@
+/*
+ * \file    Statistics.cpp
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Implementation of the statistics of a run
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "../interface/Statistics.h"
+#include "../interface/ResultWriter.h"
+
+using namespace std;
+
+namespace {
+
+const char* event_names[NUMBER_OF_EVENTS] = {"eligibility_checks", "predecessor_visits", "splits", "set_inserts"};
+
+/* \brief The position of a step in the order they run (the kernels may have different numbers of pass-two iterations)*/
+int phase_order(const string& name){
+	static const char* steps[] = {"parse", "cache_load", "cfg", "split", "registers", "pass_one"};
+	for (int k = 0; k < 6; k++)
+		if (name == steps[k])
+			return k;
+	if (name.compare(0, 9, "pass_two_") == 0)
+		return 6 + atoi(name.c_str() + 9);
+	return 1 << 20;
+}
+
+}
+
+runStatistics::runStatistics(){
+	fill(events, events + NUMBER_OF_EVENTS, 0ULL);
+}
+
+bool runStatistics::counting(){
+#ifdef REGISTER_INTERVAL_STATISTICS
+	return true;
+#else
+	return false;
+#endif
+}
+
+unsigned long long* runStatistics::counters(){
+	static thread_local unsigned long long thread_events[NUMBER_OF_EVENTS]; //every thread counts its own events, so nothing is shared in the hot paths
+	return thread_events;
+}
+
+long runStatistics::peak_memory(){
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+	return usage.ru_maxrss; //KB on Linux
+}
+
+void runStatistics::set_step_hook(function<void(const string&, double)> hook){
+	step_hook = hook;
+}
+
+void runStatistics::add_phase(const string& name, double time){
+	if (step_hook)
+		step_hook(name, time);
+	phaseStatistics P;
+	P.name = name;
+	P.time = time;
+
+	runStatistics step;
+	step.phases.push_back(P);
+	add(step);
+}
+
+void runStatistics::end_phase(const string& name, chrono::steady_clock::time_point& begin){
+	auto now = chrono::steady_clock::now();
+	add_phase(name, chrono::duration<double, milli>(now - begin).count());
+	begin = now;
+}
+
+void runStatistics::clear_counters(){
+	fill(counters(), counters() + NUMBER_OF_EVENTS, 0ULL);
+}
+
+void runStatistics::take_counters(){
+	unsigned long long* thread_events = counters();
+	for (int e = 0; e < NUMBER_OF_EVENTS; e++){
+		events[e] += thread_events[e];
+		thread_events[e] = 0;
+	}
+}
+
+void runStatistics::add(const runStatistics& s){
+	for (int p = 0; p < s.phases.size(); p++){
+		int k = 0;
+		while (k < phases.size() && phases[k].name != s.phases[p].name)
+			k++;
+		if (k == phases.size()){
+			phases.push_back(s.phases[p]);
+			stable_sort(phases.begin(), phases.end(), [](const phaseStatistics& a, const phaseStatistics& b){ return phase_order(a.name) < phase_order(b.name); });
+			continue;
+		}
+		phases[k].time += s.phases[p].time;
+	}
+	for (int e = 0; e < NUMBER_OF_EVENTS; e++)
+		events[e] += s.events[e];
+}
+
+void runStatistics::print_table() const{
+	double total = 0;
+	printf("%-16s %14s\n", "#Step", "#Time (ms)");
+	for (int p = 0; p < phases.size(); p++){
+		printf("%-16s %14.3f\n", phases[p].name.c_str(), phases[p].time);
+		total += phases[p].time;
+	}
+	printf("%-16s %14.3f\n", "total", total);
+	printf("#Peak memory of the process = %ld KB\n", peak_memory());
+
+	if (!counting()){
+		printf("The event counters are not compiled (make stats)\n");
+		return;
+	}
+	printf("%-20s %20s\n", "#Event", "#Count");
+	for (int e = 0; e < NUMBER_OF_EVENTS; e++)
+		printf("%-20s %20llu\n", event_names[e], events[e]);
+}
+
+bool runStatistics::write_json(const string& path) const{
+	resultWriter out(path);
+	if (!out.is_open())
+		return false;
+
+	char number[32];
+	out << "{\"phases\":[";
+	for (int p = 0; p < phases.size(); p++){
+		out << (p == 0 ? "\n" : ",\n") << "{\"name\":";
+		out.json_string(phases[p].name);
+		snprintf(number, sizeof(number), "%.6f", phases[p].time);
+		out << ",\"time_ms\":" << (const char*)number << "}";
+	}
+	out << "\n],\"peak_memory_kb\":" << (long long)peak_memory() << ",\"counters\":";
+	if (!counting())
+		out << "null";
+	else{
+		out << "{";
+		for (int e = 0; e < NUMBER_OF_EVENTS; e++){
+			out << (e == 0 ? "" : ",");
+			out.json_string(event_names[e]);
+			out << ":" << (long long)events[e];
+		}
+		out << "}";
+	}
+	out << "}\n";
+	return true;
+}
@@ -0,0 +1,78 @@
+/*
+ * \file    ThreadPool.cpp
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Implementation of the thread pool
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#include "../interface/ThreadPool.h"
+
+using namespace std;
+
+threadPool::threadPool(int threads){
+	running = 0;
+	stopping = false;
+	if (threads <= 0)
+		threads = thread::hardware_concurrency();
+	if (threads <= 0)
+		threads = 1;
+	for (int i = 0; i < threads; i++)
+		workers.push_back(thread(&threadPool::worker, this));
+}
+
+threadPool::~threadPool(){
+	wait();
+	{
+		unique_lock<mutex> guard(lock);
+		stopping = true;
+	}
+	job_available.notify_all();
+	for (int i = 0; i < workers.size(); i++)
+		workers[i].join();
+}
+
+void threadPool::submit(function<void()> job){
+	{
+		unique_lock<mutex> guard(lock);
+		jobs.push_back(job);
+	}
+	job_available.notify_one();
+}
+
+void threadPool::wait(){
+	unique_lock<mutex> guard(lock);
+	all_done.wait(guard, [this]{ return jobs.empty() && running == 0; });
+}
+
+int threadPool::size(){
+	return workers.size();
+}
+
+void threadPool::worker(){
+	while (true){
+		function<void()> job;
+		{
+			unique_lock<mutex> guard(lock);
+			job_available.wait(guard, [this]{ return stopping || !jobs.empty(); });
+			if (jobs.empty())
+				return;
+			job = jobs.front();
+			jobs.pop_front();
+			running++;
+		}
+
+		job();
+
+		{
+			unique_lock<mutex> guard(lock);
+			running--;
+			if (jobs.empty() && running == 0)
+				all_done.notify_all();
+		}
+	}
+}
@@ -0,0 +1,71 @@
+/*
+ * \file    BlockFrequency.h
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Interface for the execution frequency of basic blocks
+ *          Note: A PREFETCH runs every time the entry of its register-interval runs, so a register-interval that starts in a hot
+ *                loop costs far more than one in the prologue. The frequency of a basic block is estimated from loop nesting
+ *                (LOOP_WEIGHT to the power of its loop depth), or taken from a profile of execution counts.
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#ifndef BLOCKFREQUENCY_H
+#define BLOCKFREQUENCY_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../interface/ControlFlowGraph.h"
+#include "../interface/LoopForest.h"
+
+/* \brief The execution counts of basic blocks, read from a text file with one basic block per line:
+          "<basic block> <count>", or "<kernel> <basic block> <count>" for the basic blocks of one kernel
+          (empty lines and lines that start with "#" are skipped)*/
+class executionProfile
+{
+public:
+        /* Read a profile file; returns false (and prints the line) if it can not be opened or a line is not valid*/
+	bool read(const std::string& file);
+        /* Find the count of a basic block of a kernel (the count for its kernel first, then the count for all kernels)*/
+	bool find(const std::string& kernel, const std::string& block, double& count) const;
+
+        /*    Data    */
+private:
+	std::unordered_map<std::string, double> counts; //by kernel + "\n" + basic block (the kernel is empty for all kernels)
+};
+
+/* \brief The options of the frequency-weighted register-interval creation*/
+struct frequencyWeighting
+{
+	const executionProfile* profile; //the execution counts of basic blocks (nullptr: estimated from loop nesting)
+	std::string kernel;              //the name of the kernel in the profile
+};
+
+/* \brief The execution frequency of each basic block*/
+class blockFrequency
+{
+public:
+	static const int LOOP_WEIGHT = 10; //the estimated number of iterations of a loop
+
+        /* Estimate the frequencies from the loop depth of the basic blocks*/
+	void estimate(const std::vector<basicBlock*>& blocks, const loopForest& loops);
+        /* Take the frequencies from a profile; a basic block that is not in the profile gets the count of its abstract basic block
+            (e.g. the count of ".L_2" for ".L_2A"), and 0 if no basic block of its abstract basic block is in the profile*/
+	void read_profile(const std::vector<basicBlock*>& blocks, const executionProfile& profile, const std::string& kernel);
+        /* Give the second half of a split basic block the frequency of b*/
+	void split(basicBlock* b, basicBlock* second);
+
+        /* Get the frequency of a basic block*/
+	double frequency(basicBlock*) const;
+
+        /*    Data    */
+private:
+	std::vector<double> frequencies; //by basic block ID
+};
+
+#endif /* BLOCKFREQUENCY_H */
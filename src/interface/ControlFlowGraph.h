@@ -11,30 +11,100 @@
  * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
  */
 
+#ifndef CONTROLFLOWGRAPH_H
+#define CONTROLFLOWGRAPH_H
+
 #include <string>
 #include <set>
 #include <vector>
+#include <utility>
+#include <deque>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+
+#include "../implementation/Instruction.cpp"
+
+class basicBlock;
+template<typename T> class objectPool;
+
+
+/*\brief The predecessors or the successors of a node (basicBlock or registerInterval): a range of the edge array
+ *       of the objectPool of the node, which holds the IDs of the neighbours (the neighbours of a node are in its pool)
+ *       note: the edge array only grows, so a list that was got before the neighbours of its node changed stays valid.
+ */
+template<typename T>
+class neighbourList
+{
+public:
+	neighbourList(const objectPool<T>* pool, int offset, int length);
+
+	class iterator
+	{
+	public:
+		typedef std::input_iterator_tag iterator_category;  //the neighbours are made from IDs, so they are values
+		typedef T* value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef T* const* pointer;
+		typedef T* reference;
+
+		iterator(const objectPool<T>* pool, int index);
+		T* operator*() const;
+		iterator& operator++();
+		iterator operator++(int);
+		bool operator==(const iterator&) const;
+		bool operator!=(const iterator&) const;
+
+	private:
+		const objectPool<T>* pool;
+		int index;  //in the edge array
+	};
+
+        /* Get the neighbours as a range [begin(), end())*/
+	iterator begin() const;
+	iterator end() const;
+        /* Get the number of neighbours*/
+	int size() const;
+        /* Get the i-th neighbour*/
+	T* operator[](int i) const;
+
+        /*    Data    */
+private:
+	const objectPool<T>* pool;
+	int offset;
+	int length;
+};
 
 /* \brief registerInterval contains some basicBlocks and it has only one entry point
      and limited number of registers*/
 class registerInterval
 {
 public:
-	registerInterval();
+        /*Constructor of registerInterval (IDs are given by controlFlowGraph)*/
+	registerInterval(int);
 	~registerInterval();
 
         /*
          * Setters of registerInterval class
          */
 public:
-        /* Set the series of instructions in registerInterval*/
-	void set_code(std::string);
+        /* Append instructions to registerInterval (the ranges of its basicBlocks, in order)*/
+	void add_code(codeRange);
+	void add_code(const std::vector<codeRange>&);
         /* Set the register list of registerInterval*/
-	void set_register_list(std::set<std::string>);
-        /* Add a predecessor for registerInterval*/
+	void set_register_list(registerSet);
+        /* Set the registers that are live on entry to the entry basicBlock of registerInterval*/
+	void set_entry_live_list(registerSet);
+        /* Set the registers that are live when control leaves registerInterval (on any of its exit edges)*/
+	void set_exit_live_list(registerSet);
+        /* Set the objectPool of registerInterval, whose edge array holds its predecessors and successors (set by controlFlowGraph)*/
+	void set_pool(objectPool<registerInterval>*);
+        /* Add a predecessor for registerInterval (the caller adds each one once)*/
 	void add_predecessor(registerInterval*);
-        /* Add a predecessor for registerInterval*/
+        /* Add a successor for registerInterval (the caller adds each one once)*/
 	void add_successors(registerInterval*);
+        /* Add a basicBlock to registerInterval*/
+	void add_basic_block(basicBlock*);
         /* Set the next-level registerInterval that this registerInterval belongs to
             note: next-level registerInterval is used to reduce the number of registerIntervals and construct larger ones.*/
 	void set_next_level_registerInterval(registerInterval*);
@@ -49,29 +119,44 @@ public:
         /* Get the number of instructions in registerInterval*/
 	int getNumberOfInstructions();
         /* Get the register list of registerInterval*/
-	std::set<std::string> get_register_list();
-        /* Get the series of instructions in registerInterval*/
-	std::string get_code();
-        /* Get the register vector that specifies which registers are used in this registerInterval*/
-	std::vector<bool> get_register_vector();
+	registerSet get_register_list();
+        /* Get the registers that are live on entry to the entry basicBlock of registerInterval*/
+	registerSet get_entry_live_list();
+        /* Get the live-in registers of registerInterval (the registers of its register list that are live on entry),
+            the registers that its PREFETCH has to bring into the register file cache*/
+	registerSet get_live_in_list();
+        /* Get the registers that are live when control leaves registerInterval*/
+	registerSet get_exit_live_list();
+        /* Get the no-writeback registers of registerInterval (the registers of its register list that are dead on every exit edge),
+            the registers that need not be written back when they leave the register file cache*/
+	registerSet get_no_writeback_list();
+        /* Get the series of instructions in registerInterval (as ranges of text)*/
+	const std::vector<codeRange>& get_code();
+        /* Get the series of instructions in registerInterval as one string (only used for writing it out)*/
+	std::string code_text();
         /* Get the predecessors of registerInterval*/
-	std::vector<registerInterval*> get_predecessors();
+	neighbourList<registerInterval> get_predecessors();
         /* Get the successors of registerInterval*/
-	std::vector<registerInterval*> get_successors();
+	neighbourList<registerInterval> get_successors();
+        /* Get the basicBlocks of registerInterval (in the order they were added)*/
+	const std::vector<basicBlock*>& get_basic_blocks();
         /* Get the next-level registerInterval that this registerInterval belongs to*/
 	registerInterval* nextLevelInterval();
 
         /*    Data    */
 private:
-	static int IDgenerator;
 	int ID;
-	std::vector<bool> register_vector;
 	registerInterval* next_level_registerInterval;
-	std::string code;
+	std::vector<codeRange> code;
+	size_t code_length;  //the number of characters of code
 	int registerInterval_numberOfInstructions;
-	std::set<std::string> register_list;
-	std::vector<registerInterval*> predecessors;
-	std::vector<registerInterval*> successors;
+	registerSet register_list;
+	registerSet entry_live_list;
+	registerSet exit_live_list;
+	objectPool<registerInterval>* pool;
+	int predecessors_offset, predecessors_length;  //the predecessors in the edge array of pool
+	int successors_offset, successors_length;      //the successors in the edge array of pool
+	std::vector<basicBlock*> blocks;
 };
 
 
@@ -81,10 +166,10 @@ private:
 class basicBlock
 {
 public:
-        /*Constructors of basicBlock*/
-	basicBlock();
-	basicBlock(std::string);
-	basicBlock(int);
+        /*Constructors of basicBlock (IDs are given by controlFlowGraph)*/
+	basicBlock(int);                  //controling basicBlock
+	basicBlock(int, std::string);     //abstract basicBlock with a name
+	basicBlock(int, int);             //regular basicBlock of an abstract basicBlock
 	~basicBlock();
 
 	/*
@@ -93,24 +178,29 @@ public:
 public:
         /* Get the name of basicBlock*/
 	void set_name(std::string);
-        /* Get the series of instructions of basicBlock*/
-	void set_code(std::string);
+        /* Set the series of instructions of basicBlock*/
+	void set_code(codeRange);
+        /* Set the decoded instructions of basicBlock (the range [first, last) of the instruction stream of controlFlowGraph)*/
+	void set_instructions(int first, int last);
         /* Add a register to the register set of basicBlock*/
-	void add_register(std::string);
-        /* Add a predecessor for basicBlock*/
+	void add_register(int);
+        /* Set the objectPool of basicBlock, whose edge array holds its predecessors and successors (set by controlFlowGraph)*/
+	void set_pool(objectPool<basicBlock>*);
+        /* Add a predecessor for basicBlock (the caller adds each one once, e.g. with controlFlowGraph::connect)*/
 	void add_predecessor(basicBlock*);
-        /* Add a successor for basicBlock*/
+        /* Add a successor for basicBlock (the caller adds each one once, e.g. with controlFlowGraph::connect)*/
 	void add_successor(basicBlock*);
         /* Set the successors of basicBlock*/
         void set_successors(std::vector<basicBlock*>);
+        void set_successors(neighbourList<basicBlock>);
         /* Set the predecessors of basicBlock*/
         void set_predecessors(std::vector<basicBlock*>);
         /* Delete one of the successors of basicBlock*/
 	void delete_successor(basicBlock*);
         /* Set the output register list of basicBlock*/
-	void set_output_list(std::set<std::string>);
+	void set_output_list(registerSet);
         /* Set the input register list of basicBlock*/
-	void set_input_list(std::set<std::string>);
+	void set_input_list(registerSet);
         /* Clear the output register list basicBlock*/
 	void clear_output_list();
         /* Clear the input register list of basicBlock*/
@@ -136,19 +226,23 @@ public:
         /* Get the name of basicBlock*/
 	std::string get_name();
         /* Get the instructions of basicBlock*/
-	std::string get_code();
+	codeRange get_code();
 	/* Get the number of instructions in basic block*/
 	int numberOfInstructions();
+        /* Get the first decoded instruction of basicBlock (an index into the instruction stream of controlFlowGraph)*/
+	int first_instruction();
+        /* Get the end of the decoded instructions of basicBlock (one past the last one)*/
+	int last_instruction();
         /* Get the number of registers of basicBlock*/
 	int numberOfRegisters();
         /* Get the output register list of basicBlock*/
-	std::set<std::string> get_output_list();
+	registerSet get_output_list();
         /* Get the input register list of basicBlock*/
-	std::set<std::string> get_input_list();
+	registerSet get_input_list();
         /* Get the predecessors of basicBlock*/
-	std::vector<basicBlock*> get_predecessors();
+	neighbourList<basicBlock> get_predecessors();
         /* Get the successors of basicBlock*/
-	std::vector<basicBlock*> get_successors();
+	neighbourList<basicBlock> get_successors();
         /* Get the registerInterval that this basicBlock belongs to*/
 	registerInterval* RegisterInterval();
         /* Get the Abstract basicBlock that this basicBlock belongs to*/
@@ -163,19 +257,178 @@ public:
 
         /*    Data    */
 private:
-	static int IDgenerator;
-	static int IDgenerator2;
 	int ID;
 	std::string name;
-	std::string code;
+	codeRange code;
 	int NumberOfInstructions;
+	int first, last;  //decoded instructions
 	int ABB;  //Abstract Basic Block
 	bool controlBB;
 	bool exit_state;
 	basicBlock* controling_basicBlock;
-	std::vector<basicBlock*> predecessors;
-	std::vector<basicBlock*> successors;
-	std::set<std::string> input_list;
-	std::set<std::string> output_list;
+	objectPool<basicBlock>* pool;
+	int predecessors_offset, predecessors_length;  //the predecessors in the edge array of pool
+	int successors_offset, successors_length;      //the successors in the edge array of pool
+	registerSet input_list;
+	registerSet output_list;
 	registerInterval* BB_registerInterval;
 };
+
+
+/*\brief An arena of objects of one type: objects are constructed in chunks, never move,
+ *       and are all destroyed at once with the pool (the i-th object can be found by its index)
+ *       note: the pool also owns the edge array of its objects, where the neighbour list of an object is a range of IDs.
+ *             A list is never overwritten: a new list is stored at the end and a list grows in place only if it is the last one.
+ */
+template<typename T>
+class objectPool
+{
+public:
+	objectPool();
+	~objectPool();
+
+        /* Construct a new object at the end of the pool*/
+	template<typename... Args> T* create(Args&&... args);
+        /* Get the i-th object of the pool*/
+	T* get(int i) const;
+        /* Get the number of objects*/
+	int size() const;
+        /* Get the i-th entry of the edge array (the ID of a neighbour)*/
+	int32_t edge(int i) const;
+        /* Store a neighbour list at the end of the edge array; returns its offset*/
+	int store_edges(const std::vector<int32_t>& IDs);
+        /* Append a neighbour to the list [offset, offset + length) (the list is moved to the end of the edge array unless it is already there)*/
+	void append_edge(int& offset, int& length, int32_t ID);
+        /* Copy the edge array of another pool (whose objects have the same IDs and neighbour lists)*/
+	void copy_edges(const objectPool& other);
+
+        /*    Data    */
+private:
+	objectPool(const objectPool&) = delete;
+	objectPool& operator=(const objectPool&) = delete;
+
+	static const int CHUNK = 256;  //objects per chunk
+	std::vector<T*> chunks;
+	int count;
+	std::vector<int32_t> edges;  //the neighbour lists of the objects
+};
+
+
+/*\brief Compressed sparse row (CSR) adjacency of a graph whose nodes are IDs (0 ... n-1)
+ *       note: the neighbours of node x are stored contiguously in targets[offsets[x] ... offsets[x+1]-1],
+ *             in the order the edges were given; nodes out of range have no neighbours.
+ */
+class csrAdjacency
+{
+public:
+	csrAdjacency();
+
+        /* Build the adjacency of n nodes from (node, neighbour) pairs*/
+	void build(int n, const std::vector<std::pair<int, int>>& edges);
+        /* Get the neighbours of node x as a range [begin(x), end(x))*/
+	const int* begin(int x) const;
+	const int* end(int x) const;
+        /* Get the number of neighbours of node x*/
+	int size(int x) const;
+        /* Get the number of nodes*/
+	int nodes() const;
+
+        /*    Data    */
+private:
+	std::vector<int> offsets;
+	std::vector<int> targets;
+};
+
+
+/*\brief Marks of nodes whose IDs are 0 ... n-1 for one query at a time (e.g. the frontier of one register-interval)
+ *       note: a node is marked if its stamp is the current epoch, so a new query clears all marks in O(1) and the
+ *             storage is one stamp per node for the whole run (it grows only when nodes with larger IDs are marked).
+ */
+class epochMarks
+{
+public:
+	epochMarks();
+
+        /* Start a new query (all nodes are unmarked)*/
+	void next_epoch();
+        /* Mark node x; returns false if it is already marked in this query*/
+	bool mark(int x);
+        /* Is node x marked in this query*/
+	bool marked(int x) const;
+
+        /*    Data    */
+private:
+	std::vector<unsigned> stamps;
+	unsigned epoch;
+};
+
+
+/*\brief controlFlowGraph owns the basicBlocks and registerIntervals of one application (kernel) and gives them their IDs
+ *       note: IDs are compact and start from zero in every controlFlowGraph, so they can index vectors directly
+ *             and a node can be found by its ID. Abstract and controling basicBlocks share one sequence of IDs and
+ *             regular basicBlocks (including the ones created by splitting) have another. The objects and their edges live in arenas
+ *             (objectPool) that are released at once with the controlFlowGraph, and two controlFlowGraphs share no state,
+ *             so different kernels can be processed in different threads.
+ */
+class controlFlowGraph
+{
+public:
+	controlFlowGraph();
+	~controlFlowGraph();
+
+        /*
+         * Factories of controlFlowGraph class
+         */
+public:
+        /* Create an abstract basicBlock (a node of the nvdisasm CFG)*/
+	basicBlock* new_abstract_basicBlock(std::string name);
+        /* Create a controling basicBlock*/
+	basicBlock* new_controling_basicBlock();
+        /* Create a regular basicBlock that belongs to an abstract basicBlock*/
+	basicBlock* new_basicBlock(int ABB);
+        /* Create an empty registerInterval*/
+	registerInterval* new_registerInterval();
+        /* Keep a text that is not in the input buffer (e.g. renamed instructions) as long as the controlFlowGraph*/
+	codeRange keep_text(std::string text);
+        /* Decode the instructions of a basicBlock and append them to the instruction stream*/
+	void decode_instructions(basicBlock*);
+        /* Append a decoded instruction to the instruction stream (e.g. an instruction of the binary CFG cache)*/
+	void add_instruction(const instruction&);
+        /* Copy the basicBlocks and the instruction stream of another controlFlowGraph (a snapshot that has no registerIntervals yet)
+            into this empty controlFlowGraph; the copies get the same IDs and the codes still refer to the text of the snapshot,
+            so the snapshot should outlive the copy. Used to run the passes (which split basicBlocks) several times on one CFG.*/
+	void copy_basicBlocks(const controlFlowGraph& snapshot);
+        /* Add the edges (predecessor, successor) between basicBlocks of one kind (abstract or regular) in the given order; an edge that
+            is given more than once is added once, so the predecessors and successors of each basicBlock are in the order of their first edges*/
+	void connect(const std::vector<std::pair<basicBlock*, basicBlock*>>& edges);
+
+        /*
+         * Getters of controlFlowGraph class
+         */
+public:
+        /* Get the number of regular basicBlocks (their IDs are less than this number)*/
+	int number_of_basicBlocks();
+        /* Get the number of registerIntervals (their IDs are less than this number)*/
+	int number_of_registerIntervals();
+        /* Get a regular basicBlock by its ID*/
+	basicBlock* basic_block(int ID);
+        /* Get a registerInterval by its ID*/
+	registerInterval* register_interval(int ID);
+        /* Get the number of decoded instructions*/
+	int number_of_instructions();
+        /* Get a decoded instruction by its index in the instruction stream*/
+	const instruction& get_instruction(int i);
+
+        /*    Data    */
+private:
+	controlFlowGraph(const controlFlowGraph&) = delete;
+	controlFlowGraph& operator=(const controlFlowGraph&) = delete;
+
+	objectPool<basicBlock> abstract_blocks;  //abstract and controling basicBlocks
+	objectPool<basicBlock> blocks;           //regular basicBlocks
+	objectPool<registerInterval> intervals;
+	std::deque<std::string> texts;           //texts kept by keep_text
+	std::vector<instruction> instructions;   //the instruction stream (the instructions of each basicBlock are contiguous)
+};
+
+#endif /* CONTROLFLOWGRAPH_H */
@@ -0,0 +1,56 @@
+/*
+ * \file    DominatorTree.h
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Interface for the dominator tree of the basic block CFG
+ *          Note: The edges of CFG are taken from the predecessor lists of basic blocks and the basic blocks
+ *                with no predecessors are the entries of CFG (children of a virtual root).
+ *                Besides dominance, the tree records the strongly connected components of CFG,
+ *                so the register-interval creation pass can tell which basic blocks lie on a common cycle.
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#ifndef DOMINATORTREE_H
+#define DOMINATORTREE_H
+
+#include <vector>
+
+#include "../interface/ControlFlowGraph.h"
+
+/* \brief Dominator tree (Cooper-Harvey-Kennedy algorithm) and strongly connected components (Tarjan) of CFG*/
+class dominatorTree
+{
+public:
+	dominatorTree();
+
+        /* Build the dominator tree of the basic blocks*/
+	void build(std::vector<basicBlock*> blocks);
+        /* Add a basic block whose only predecessor is parent (the second half of a split basic block)
+            note: such a basic block is a leaf of the tree and forms a component on its own*/
+	void add_leaf(basicBlock* b, basicBlock* parent);
+
+        /* Does a dominate b (every path from an entry to b passes through a)*/
+	bool dominates(basicBlock* a, basicBlock* b);
+        /* Get the immediate dominator of a basic block (nullptr for entries and unreachable basic blocks)*/
+	basicBlock* immediate_dominator(basicBlock*);
+        /* Are a and b on a common cycle of CFG (in the same strongly connected component)*/
+	bool same_component(basicBlock* a, basicBlock* b);
+
+        /*    Data    */
+private:
+	void resize(int);
+
+	std::vector<basicBlock*> block;  //basic block of each slot (slots are basic block IDs)
+	std::vector<int> idom;           //slot of the immediate dominator (-1 for entries and unreachable basic blocks)
+	std::vector<int> preorder;       //preorder number in the dominator tree (-1 for unreachable basic blocks and leaves)
+	std::vector<int> last;           //largest preorder number in the subtree
+	std::vector<int> component;      //strongly connected component
+	std::vector<bool> leaf;          //added by add_leaf
+	int components;
+};
+
+#endif /* DOMINATORTREE_H */
@@ -0,0 +1,48 @@
+/*
+ * \file    DotGenerator.h
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Interface for the generator of synthetic CFGs in the Graphviz Dot format of nvdisasm
+ *          Note: The generated code has the same record labels ("<entry>" and "<exitN>" fields) and
+ *                edges (":exitN:e" branches, ":exitN:s" and ":entry:s" fall-throughs) as nvdisasm, so it is used
+ *                to measure how parsing and both passes scale to kernels with many basic blocks.
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#ifndef DOTGENERATOR_H
+#define DOTGENERATOR_H
+
+#include <string>
+
+#include "RegisterSet.h"
+#include "ResultWriter.h"
+
+/* \brief The parameters of a synthetic CFG*/
+struct generatorOptions
+{
+	int blocks;               //the number of basic blocks (nodes) of each kernel
+	int kernels;              //the number of kernels (clusters)
+	int loop_depth;           //the maximum nesting depth of loops (0: no loops)
+	double branch_density;    //the probability that a block ends with a conditional forward branch
+	int min_instructions;     //the number of instructions of a block is chosen uniformly from [min_instructions, max_instructions]
+	int max_instructions;
+	int registers;            //the instructions use registers R0 ... R(registers-1)
+	unsigned seed;
+
+	generatorOptions();
+};
+
+/* \brief This class writes random CFGs of structured code (nested loops and forward branches) as nvdisasm would print them*/
+class DotGenerator
+{
+public:
+    /* \brief Writes the CFG (the code is streamed, so very large CFGs need little memory)
+        -Returns the number of edges*/
+    static long long generate(const generatorOptions& options, resultWriter& out);
+};
+
+#endif /* DOTGENERATOR_H */
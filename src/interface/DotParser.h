@@ -0,0 +1,87 @@
+/*
+ * \file    DotParser.h
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Interface for the parser of Graphviz Dot code generated by nvdisasm
+ *          Note: The input file is memory-mapped and tokenized in one linear pass; nodes and edges
+ *                refer to the mapped buffer by offset, so nothing is copied while parsing.
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#ifndef DOTPARSER_H
+#define DOTPARSER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/* \brief A range of characters of the input buffer*/
+struct textSpan
+{
+	size_t offset;
+	size_t length;
+};
+
+/* \brief A node of nvdisasm CFG (an abstract basic block)*/
+struct dotNode
+{
+	textSpan name; //The quoted name of the node (without quotes)
+	textSpan code; //The record label of the node without the surrounding "{" and "\l}"
+	int cluster;   //The cluster (kernel) that contains the node (-1 if it is not in a cluster)
+};
+
+/* \brief An edge of nvdisasm CFG*/
+struct dotEdge
+{
+	textSpan source; //The name of the source node
+	textSpan target; //The name of the target node
+	bool fallthrough; //true for ":entry:s" edges (blocks without branches), false for ":exit..." edges
+	int cluster;      //The cluster (kernel) of the edge statement (-1 if it is not in a cluster)
+};
+
+/* \brief A read-only view of the whole input file (memory-mapped when possible)*/
+class mappedFile
+{
+public:
+	mappedFile();
+	~mappedFile();
+
+        /* Map the file; returns false if the file can not be opened*/
+	bool open(const char* file_name);
+        /* Unmap the file*/
+	void close();
+
+	const char* data() const;
+	size_t size() const;
+        /* Copy a span of the file into a string*/
+	std::string text(textSpan) const;
+
+private:
+	mappedFile(const mappedFile&);
+	mappedFile& operator=(const mappedFile&);
+
+	const char* buffer;
+	size_t length;
+	bool mapped;
+	std::string fallback; //used when the file can not be mapped (e.g. an empty file)
+};
+
+/* \brief This class tokenizes the Graphviz Dot code of nvdisasm in a single pass*/
+class DotParser
+{
+public:
+    /* \brief Parses the input buffer
+        -Input: the mapped Dot file
+        -Output: the nodes and edges of the CFG in the order they appear in the file
+        -Returns false if the buffer is not a well-formed digraph*/
+    static bool parse(const mappedFile& file, std::vector<dotNode>& nodes, std::vector<dotEdge>& edges);
+    /* \brief Parses the input buffer and also returns the names of the clusters ("subgraph "cluster_<kernel>"", one per kernel of nvdisasm);
+              the cluster field of nodes and edges is an index into clusters*/
+    static bool parse(const mappedFile& file, std::vector<dotNode>& nodes, std::vector<dotEdge>& edges, std::vector<textSpan>& clusters);
+};
+
+#endif /* DOTPARSER_H */
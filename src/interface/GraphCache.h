@@ -0,0 +1,129 @@
+/*
+ * \file    GraphCache.h
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Interface for the binary cache of control flow graphs
+ *          Note: The basic blocks of every kernel of an input file (as created from the Dot code, before the passes) are
+ *                written to a cache file named after the content hash of the input, so a repeated run maps the cache file
+ *                instead of parsing the Dot code. A changed input has another hash (and another cache file).
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#ifndef GRAPHCACHE_H
+#define GRAPHCACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "DotParser.h"
+#include "ControlFlowGraph.h"
+
+/* \brief The records of a cache file; all of them are 8-byte aligned and they are read in place from the mapped file
+     layout: cacheHeader, cacheSpan[clusters], cacheKernel[kernels], and the section of each kernel:
+             cacheSection, cacheBlock[blocks], cacheInstruction[instructions], int32_t[adjacency] and char[names] (both padded to 8 bytes)
+     note: the code of blocks and instructions is stored as ranges of the input file, so the input is still mapped with its cache.*/
+struct cacheHeader
+{
+	char magic[8];         //"RICFG" followed by zeros
+	uint32_t version;      //GraphCache::VERSION
+	uint32_t clusters;     //the number of clusters of the input
+	uint32_t kernels;      //the number of kernels of the input
+	uint32_t registers;    //registerSet::MAX_REGISTERS (the layout of register sets)
+	uint64_t hash;         //the content hash of the input
+	uint64_t input_size;   //the size of the input
+};
+
+struct cacheSpan
+{
+	uint64_t offset;
+	uint64_t length;
+};
+
+struct cacheKernel
+{
+	int32_t cluster;       //the cluster of the kernel (-1 for the nodes that are not in a cluster)
+	uint32_t reserved;
+	uint64_t size;         //the number of code characters of the kernel
+	uint64_t section;      //the offset of the section of the kernel in the cache file
+	uint64_t section_length;
+};
+
+struct cacheSection
+{
+	uint32_t blocks;
+	uint32_t instructions;
+	uint32_t adjacency;    //the predecessors and then the successors of each block (IDs)
+	uint32_t names;        //the characters of the names of the blocks
+};
+
+struct cacheBlock
+{
+	int32_t ABB;
+	int32_t first, last;   //the decoded instructions of the block (indices into the instructions of the section)
+	int32_t predecessors;  //the number of predecessors
+	int32_t successors;    //the number of successors
+	uint32_t name_offset, name_length;
+	uint32_t reserved;
+	cacheSpan code;
+	registerSet registers;
+};
+
+struct cacheInstruction
+{
+	cacheSpan text;
+	cacheSpan opcode;
+	int32_t guard;
+	int32_t negated_guard;
+	registerSet defs;
+	registerSet uses;
+};
+
+/* \brief A cache file of an input file (mapped when it is opened)*/
+class graphCache
+{
+public:
+	static const uint32_t VERSION = 2;
+
+	graphCache();
+
+        /* Map the cache file at path; returns false if there is no valid cache file of the input (another hash, size or version)*/
+	bool open(const std::string& path, uint64_t hash, size_t input_size);
+        /* Unmap the cache file*/
+	void close();
+        /* Get the number of kernels (in the order find_kernels creates them)*/
+	int number_of_kernels() const;
+        /* Get the cluster of the k-th kernel*/
+	int kernel_cluster(int k) const;
+        /* Get the number of code characters of the k-th kernel*/
+	size_t kernel_size(int k) const;
+        /* Get the clusters of the input*/
+	std::vector<textSpan> clusters() const;
+        /* Create the basic blocks of the k-th kernel in graph (the same basic blocks, with the same IDs, as create_control_flow_graph)*/
+	std::vector<basicBlock*> load_kernel(int k, const mappedFile& input, controlFlowGraph& graph) const;
+
+        /* Get the content hash of an input (64 bits, not cryptographic)*/
+	static uint64_t content_hash(const char* data, size_t size);
+        /* Get the path of the cache file of an input in a directory*/
+	static std::string file_name(const std::string& directory, uint64_t hash);
+        /* Write the section of a kernel (its basic blocks before the passes) into section; returns false if a code is not in the input*/
+	static bool save_kernel(controlFlowGraph& graph, const std::vector<basicBlock*>& blocks, const mappedFile& input, std::string& section);
+        /* Write a cache file (the kernels are given by their cluster, size and section); the file is replaced atomically*/
+	static bool write(const std::string& path, uint64_t hash, size_t input_size, const std::vector<textSpan>& clusters,
+	                  const std::vector<int>& kernel_clusters, const std::vector<size_t>& kernel_sizes, const std::vector<std::string>& sections);
+
+        /*    Data    */
+private:
+	bool valid_section(const cacheKernel& K, size_t input_size) const;
+
+	mappedFile file;
+	const cacheHeader* header;
+	const cacheSpan* cluster_spans;
+	const cacheKernel* kernels;
+};
+
+#endif /* GRAPHCACHE_H */
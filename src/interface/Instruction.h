@@ -0,0 +1,78 @@
+/*
+ * \file    Instruction.h
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Interface for the decoded SASS instructions of basic blocks
+ *          Note: The instructions of a basic block are the pieces of its code that end with ";" (nvdisasm writes one
+ *                instruction per line, after labels and directives). Each of them is decoded once into an instruction
+ *                record, so splitting basic blocks and counting registers work on register sets instead of text.
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#ifndef INSTRUCTION_H
+#define INSTRUCTION_H
+
+#include <string>
+#include <vector>
+
+#include "../implementation/RegisterSet.cpp"
+
+/* \brief A range [begin, end) of instruction text in the input buffer (or in a text kept by controlFlowGraph)
+     note: basicBlocks and registerIntervals refer to their instructions by ranges, so the text is never copied
+           while the CFG is built and the register-intervals are created.*/
+struct codeRange
+{
+	const char* begin;
+	const char* end;
+
+	codeRange();
+	codeRange(const char* b, const char* e);
+
+        /* Get the number of characters*/
+	size_t size() const;
+        /* Find s in the range, starting at pos (like std::string::find, returns std::string::npos if s is not found)*/
+	size_t find(const char* s, size_t pos = 0) const;
+	size_t find(const std::string& s, size_t pos = 0) const;
+        /* Get the subrange of n characters starting at pos (clipped to the range, like std::string::substr)*/
+	codeRange sub(size_t pos, size_t n = std::string::npos) const;
+        /* Get the number of occurrences of a character*/
+	int count(char c) const;
+        /* Copy the range into a string*/
+	std::string str() const;
+};
+
+/* \brief A decoded SASS instruction (e.g. "@!P0 IADD R2.CC, R2, c[0x0][0x20]")*/
+struct instruction
+{
+	codeRange text;       //the characters of the instruction in the input, from the end of the previous instruction up to its ";"
+	codeRange opcode;     //e.g. "IADD" (empty if no opcode is found)
+	int guard;            //the predicate of the guard (0-6 for P0-P6, 7 for PT), -1 if the instruction is not guarded
+	bool negated_guard;   //the guard is "@!P"
+	registerSet defs;     //the destination register
+	registerSet uses;     //all other registers (sources, addresses and the registers of stores)
+
+        /* Get all registers of the instruction (defs and uses)*/
+	registerSet registers() const;
+};
+
+/* \brief This class decodes the code of basic blocks into instructions*/
+class instructionDecoder
+{
+public:
+    /* \brief Decodes one instruction from its text (without ";")*/
+    static instruction decode(codeRange text);
+
+    /* \brief Finds the beginning of the instruction in its text (after the labels and directives on the lines before it
+              and after the name of a record field, e.g. "exitpost0>")*/
+    static const char* instruction_line(codeRange text);
+
+    /* \brief Decodes all instructions (the pieces of code that end with ";") of a basic block and appends them to stream
+        -Returns the number of decoded instructions*/
+    static int decode_all(codeRange code, std::vector<instruction>& stream);
+};
+
+#endif /* INSTRUCTION_H */
@@ -0,0 +1,111 @@
+/*
+ * \file    Kernel.h
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Interface for the kernels of the input files: parsing, creating the CFG of a kernel,
+ *          running the register-interval creation passes and generating the output logs
+ *          Note: These steps are shared by the main program and the benchmark.
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../implementation/DotParser.cpp"
+#include "../implementation/RegisterIntervalCreation.cpp"
+#include "../implementation/GraphCache.cpp"
+#include "../implementation/ResultWriter.cpp"
+#include "../implementation/Statistics.cpp"
+
+/* \brief A parsed input file (the Graphviz Dot code of nvdisasm)*/
+struct inputFile
+{
+	std::string name;
+	mappedFile file;
+	std::vector<dotNode> nodes;
+	std::vector<dotEdge> edges;
+	std::vector<textSpan> clusters; //the kernels of the file (nvdisasm puts each function in a cluster)
+	bool valid;                     //the file could be opened
+	double time;                    //parsing time (ms)
+	std::string cache_name;         //the path of its cache file (empty if the cache is not used)
+	uint64_t hash;                  //the content hash of the file (only if the cache is used)
+	graphCache cache;
+	bool cached;                    //the kernels are loaded from the cache file (nodes and edges are not parsed)
+};
+
+/* \brief A kernel (a cluster of an input file); the kernels are processed independently and each of them has its own output logs*/
+struct kernel
+{
+	inputFile* input;
+	int cluster;          //index of the cluster in input->clusters (-1 for the nodes that are not in a cluster)
+	int index;            //the position of the kernel in its file (and in its cache file)
+	std::string log_name; //the name used in the output logs
+	std::string name;     //the name of the kernel in the output logs (empty if the file has only one kernel)
+	std::string function; //the name of the kernel function (its cluster), used to find its basic blocks in a profile
+	size_t size;          //the number of code characters, used to schedule the largest kernels first
+	int intervals;        //the number of final register-intervals
+	double time;          //the time of both passes (ms)
+	double weighted_prefetches; //the weighted number of PREFETCH instructions that run (only with frequency weighting)
+	int loops;            //the number of natural loops
+	int contained_loops;  //the number of natural loops that are fully contained in one register-interval
+	std::string section;  //the basic blocks of the kernel for the cache file (if the input is not cached)
+	bool saved;           //section is written
+	runStatistics statistics; //the time of each step and the event counters (only with --stats)
+};
+
+/* \brief This function gets the nodes and edges of a kernel (Graphviz Dot code of CFG) and generates the basic blocks of application
+           (the time of its steps is added to statistics if it is not nullptr)*/
+std::vector<basicBlock*> create_control_flow_graph(const inputFile& input, int cluster, controlFlowGraph& graph, runStatistics* statistics);
+
+/* \brief Splits abstract basic blocks to regular basic blocks*/
+std::vector<basicBlock*> split_abstract_basic_blocks(std::vector<basicBlock*>, controlFlowGraph& graph);
+
+/* \brief generates a log that contains all information about the basic blocks and CFG (file: "basicBlocks.txt") */
+void basic_blocks_log(std::vector<basicBlock*> BBs, const kernel& K);
+
+/* \brief generates a log that contains all information about the register-intervals and register-interval creation algorithm (file: "registerIntervals.txt") */
+void registerInterval_log(std::vector<registerInterval*> intervals, const kernel& K);
+
+/* \brief generates the machine-readable logs (JSON lines or CSV) of the basic blocks of graph (after splitting, with the register-interval
+           that each of them belongs to) and of the register-intervals (files: "BasicBlocks.jsonl|csv" and "registerIntervals.jsonl|csv") */
+void structured_logs(controlFlowGraph& graph, const std::vector<registerInterval*>& intervals, const kernel& K, logFormat format);
+
+/* \brief writes the code of the kernel (its Dot nodes without the escapes, with the labels and directives of nvdisasm) with the name of each basic block
+           before its first instruction and a "PREFETCH <register bitmask>" pseudo-instruction at the entry of each register-interval
+           (the live-in registers with the BUDGET_LIVE_IN budget, all registers of the register-interval otherwise) (file: "AnnotatedSASS.sass")
+           note: the nodes of the input are needed, so a cached input should be parsed too*/
+void annotated_sass_log(controlFlowGraph& graph, const std::vector<registerInterval*>& intervals, const kernel& K, registerBudget budget);
+
+/* \brief maps and parses an input file (or maps its cache file from the cache directory if it has one)*/
+void parse_input_file(inputFile& input, const std::string& cache_directory);
+
+/* \brief creates the basic blocks of a kernel from its cache file, or from the Dot code (and then saves them for the cache file);
+           the time of its steps is added to statistics if it is not nullptr*/
+std::vector<basicBlock*> kernel_basic_blocks(kernel& K, controlFlowGraph& graph, runStatistics* statistics);
+
+/* \brief writes the cache file of an input file if it was not cached and all of its kernels are saved*/
+void write_cache_file(inputFile& input, const std::vector<kernel>& kernels);
+
+/* \brief gets the kernels of a parsed input file*/
+std::vector<kernel> find_kernels(inputFile* input);
+
+/* \brief runs both passes of the register-interval creation algorithm on the basic blocks of graph (REGNUM limits the registers given by budget,
+           the basic blocks are weighted by their execution frequency if weighting is not nullptr, natural loops are admitted as units if
+           loop_admission is true, and all split points of a basic block are planned at once if split_planning is true) and returns the final
+           register-intervals;
+           the time of pass one and pass two is added to pass_time[0] and pass_time[1] (ms), the weighted number of PREFETCH instructions that run
+           to weighted_prefetches (with weighting), the number of natural loops and of the loops that are fully contained in one register-interval
+           to loop_count[0] and loop_count[1], and the time of pass one and each iteration of pass two to statistics (if they are not nullptr; with a step hook, statistics
+           also gives the time of each step to its caller)*/
+std::vector<registerInterval*> register_interval_passes(controlFlowGraph& graph, std::vector<basicBlock*> basic_blocks, int REGNUM, registerBudget budget, const frequencyWeighting* weighting,
+                                                        bool loop_admission, bool split_planning, double pass_time[2], double* weighted_prefetches, int loop_count[2], runStatistics* statistics);
+
+#endif /* KERNEL_H */
@@ -0,0 +1,55 @@
+/*
+ * \file    Liveness.h
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Interface for the liveness analysis of registers over the basic block CFG
+ *          Note: A register is live at a point if it may be read later before it is written. Only the registers that are live
+ *                on entry to a register-interval (and used in it) have to be prefetched; the others are written before they are
+ *                read, or not read at all. A guarded definition (e.g. "@P0 MOV R2, R3") may not execute, so it does not end
+ *                the liveness of its register. As in the dominator tree, the edges are taken from the predecessor lists.
+ *                A call (CAL, JCAL) or a return (RET) leaves the function, and the callee or the caller may read any register
+ *                (the registers of the arguments and results depend on the ABI), so all registers are live before it.
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#ifndef LIVENESS_H
+#define LIVENESS_H
+
+#include <vector>
+
+#include "../interface/ControlFlowGraph.h"
+
+/* \brief Backward liveness analysis (live-in and live-out registers of each basic block)*/
+class livenessAnalysis
+{
+public:
+        /* Compute the live registers of the basic blocks (an iterative data-flow analysis over CFG until nothing changes)*/
+	void build(const std::vector<basicBlock*>& blocks, controlFlowGraph& graph);
+        /* Update the live registers after b was split into b and second (the instructions of second are the end of the old b)*/
+	void split(basicBlock* b, basicBlock* second, controlFlowGraph& graph);
+        /* The same after a basic block (parts[0]) was split into a chain of basic blocks (each is the only predecessor of the next one)*/
+	void split(const std::vector<basicBlock*>& parts, controlFlowGraph& graph);
+
+        /* Get the registers that are live on entry to a basic block*/
+	registerSet live_in(basicBlock*) const;
+        /* Get the registers that are live at the end of a basic block*/
+	registerSet live_out(basicBlock*) const;
+
+        /* Get the registers that are live before the instructions [first, last) of graph if live is the set after them*/
+	static registerSet transfer(controlFlowGraph& graph, int first, int last, registerSet live);
+        /* Does the instruction leave the function (a call or a return)*/
+	static bool leaves_function(const instruction& I);
+        /* Get the set of all registers (the registers that may be read after an instruction that leaves the function)*/
+	static registerSet all_registers();
+
+        /*    Data    */
+private:
+	std::vector<registerSet> in;   //by basic block ID
+	std::vector<registerSet> out;  //by basic block ID
+};
+
+#endif /* LIVENESS_H */
@@ -0,0 +1,58 @@
+/*
+ * \file    LoopForest.h
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Interface for the natural loops of the basic block CFG
+ *          Note: An edge p -> h is a back edge if h dominates p; the natural loop of h is h and the basic blocks that reach
+ *                the sources of its back edges without passing h (the back edges of one header form one loop). Two natural
+ *                loops are nested or disjoint, so they form a forest. Cycles that are not entered through a dominating
+ *                header (irreducible code) are not loops. As in the dominator tree, the edges are taken from the predecessor lists.
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#ifndef LOOPFOREST_H
+#define LOOPFOREST_H
+
+#include <vector>
+
+#include "../interface/ControlFlowGraph.h"
+#include "../interface/DominatorTree.h"
+
+/* \brief The natural loops of CFG and their nesting*/
+class loopForest
+{
+public:
+        /* Find the natural loops of the basic blocks (dominators should be built on the same basic blocks)*/
+	void build(const std::vector<basicBlock*>& blocks, dominatorTree& dominators);
+        /* Add the second half of a split basic block to the loops of b*/
+	void split(basicBlock* b, basicBlock* second);
+
+        /* Get the number of loops (they are numbered in the order of their headers in the basic blocks)*/
+	int number_of_loops() const;
+        /* Get the header of a loop*/
+	basicBlock* header(int loop) const;
+        /* Get the basic blocks of a loop (the header first, then the others in the order of the basic blocks and the second halves of split basic blocks)*/
+	const std::vector<basicBlock*>& loop_blocks(int loop) const;
+        /* Get the innermost loop that contains a loop (-1 for outermost loops)*/
+	int parent(int loop) const;
+        /* Get the loop whose header is a basic block (-1 if it is not a loop header)*/
+	int header_loop(basicBlock*) const;
+        /* Get the innermost loop that contains a basic block (-1 if it is in no loop)*/
+	int innermost_loop(basicBlock*) const;
+        /* Get the number of loops that contain a basic block*/
+	int depth(basicBlock*) const;
+
+        /*    Data    */
+private:
+	std::vector<basicBlock*> headers;
+	std::vector<std::vector<basicBlock*>> loops;
+	std::vector<int> parents;
+	std::vector<int> loop_depth;   //by loop
+	std::vector<int> innermost;    //by basic block ID
+};
+
+#endif /* LOOPFOREST_H */
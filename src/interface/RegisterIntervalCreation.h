@@ -29,32 +29,129 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <queue>
 
 #include "../implementation/ControlFlowGraph.cpp"
+#include "../implementation/DominatorTree.cpp"
+#include "../implementation/Liveness.cpp"
+#include "../implementation/LoopForest.cpp"
+#include "../implementation/BlockFrequency.cpp"
 
-/* \brief This class implements the register-interval creation algorithm.*/
+/* \brief The registers that are limited by the allowed number of registers of a register-interval*/
+enum registerBudget
+{
+	BUDGET_ALL_REGISTERS,  //all registers of the register-interval (its working set)
+	BUDGET_LIVE_IN         //only its live-in registers (the registers that are prefetched), so register-intervals can be larger
+};
+
+/* \brief This class implements the register-interval creation algorithm.
+    note: All state of the algorithm belongs to an instance, and the basic blocks and register-intervals belong to its controlFlowGraph,
+          so passes on different controlFlowGraphs can run in different threads at the same time.*/
 class RegisterIntervalCreationPass{
 public:
+    /* \brief the new basic blocks (splitting) and register-intervals are created in graph*/
+    RegisterIntervalCreationPass(controlFlowGraph& graph);
+
+    /* \brief sets the registers that are limited by the allowed number (all registers by default)*/
+    void set_register_budget(registerBudget budget);
+
+    /* \brief weights the basic blocks by their execution frequency (nullptr: not weighted, the default); then the candidates of a
+              register-interval are visited hottest first in pass one, and pass two merges the register-intervals across their hottest
+              entry edges first (merge_hottest_first), so fewer PREFETCH instructions run in hot code*/
+    void set_frequency_weighting(const frequencyWeighting* weighting);
+
+    /* \brief admits the natural loops as units (off by default): a loop header whose predecessors outside its loop belong to the current
+              register-interval joins it with its whole loop if the registers of the loop fit (in pass one the basic blocks of the loop,
+              in pass two the register-intervals that contain them), so no PREFETCH runs on every iteration of the loop
+              (with frequency weighting pass two admits the loops in merge_hottest_first, when their headers are visited)*/
+    void set_loop_admission(bool admission);
+
+    /* \brief plans all split points of a basic block at once (off by default): a basic block with more than the allowed number of
+              registers is split into the fewest parts that fit (and among them the parts with the fewest registers live at the split
+              points) in one pass, instead of at the first instruction that does not fit, one part after the other*/
+    void set_split_planning(bool planning);
+
+    /* \brief the number of natural loops of the basic blocks (after pass one)*/
+    int loop_count() const;
+    /* \brief the number of natural loops whose basic blocks all belong to one of the register-intervals*/
+    int contained_loop_count(const std::vector<registerInterval*>& intervals);
+
+    /* \brief the weighted number of PREFETCH instructions that run: the sum of the frequencies of the entries of the register-intervals
+              (only with frequency weighting)*/
+    double weighted_prefetch_count(const std::vector<registerInterval*>& intervals) const;
+
     /* \brief the first pass of registerInterval creation algorithm
         -Input: Basic blocks of control flow graph, the maximum number of registers that each register-interval can contain
         -Output: Register-registerIntervals*/
-    static std::vector<registerInterval*> registerIntervalCreationPassOne(std::vector<basicBlock*> inputBlocks, int registerNumber);
+    std::vector<registerInterval*> registerIntervalCreationPassOne(std::vector<basicBlock*> inputBlocks, int registerNumber);
    
     /* \brief the second pass of register-interval creation algorithm
         -Input: Register-registerIntervals, the maximum number of registers that each register-interval can contain
         -Output: Reduced register-register-intervals*/
-    static std::vector<registerInterval*> registerIntervalCreationPassTwo(std::vector<registerInterval*> inputIntervls, int registerNumber);
+    std::vector<registerInterval*> registerIntervalCreationPassTwo(std::vector<registerInterval*> inputIntervls, int registerNumber);
     
     /* \brief traverses a basic block instructions and splits it into two blocks if its number of registers
-              is more than the maximum number.*/
-    static void traverse(basicBlock*,int);
-    
-    /* \brief four functions that traverse the control flow graph (that the nodes are basic blocks or register-intervals)
-              and marks the predecessors of a specified node.*/
-    static void visit_all_predecessors(basicBlock*);
-    static void visit_registerInterval_all_predecessors(registerInterval*);
-    static void visit_predecessors(basicBlock*);
-    static void registerInterval_visit_predecessors(registerInterval*);
+              is more than the maximum number (or into all the parts planned by plan_splits with split planning).*/
+    void traverse(basicBlock*,int);
+
+    /*    Data    */
+private:
+    /* \brief the number of registers of a set that count against the allowed number in a register-interval whose entry has
+              the live registers entry_live*/
+    int budget_size(const registerSet& registers, const registerSet& entry_live) const;
+    /* \brief the same for the union of two sets (without constructing the union if all registers are limited)*/
+    int budget_union_size(const registerSet& a, const registerSet& b, const registerSet& entry_live) const;
+    /* \brief the instructions at which a basic block is split with split planning (none if it fits), so each part has at most N registers
+              (the first part counted against entry_live, the others against the live registers at their first instruction)*/
+    std::vector<int> plan_splits(basicBlock* BB, int N, const registerSet& entry_live);
+    /* \brief splits a basic block at the instructions cuts into a chain of basic blocks, each after the first in a new register-interval,
+              and sets the registers of the parts*/
+    void split_at(basicBlock* BB, const std::vector<int>& cuts);
+    /* \brief pass two with frequency weighting: merges the register-intervals across their hottest entry edges first (a register-interval
+              joins the group of its predecessors), so the budget goes to the merges that remove the PREFETCH instructions that run most
+              (e.g. a loop that fits joins the register-interval before it before a cold successor of that register-interval does). Creates
+              the next-level register-intervals and their members. With loop admission, a register-interval whose entry heads a loop that
+              its predecessors leave in several groups joins with the whole loop (level_of: the input register-interval of each basic block)*/
+    void merge_hottest_first(const std::vector<registerInterval*>& inputIntervals, int N, const std::vector<int>& interval_position,
+                             const std::vector<registerInterval*>& level_of, std::vector<registerInterval*>& outputIntervals,
+                             std::vector<std::vector<registerInterval*>>& members);
+    /* \brief sets the registers that are live when control leaves each register-interval: the live-in registers of the
+              basic blocks outside the register-interval that its basic blocks branch or fall through to*/
+    void set_exit_live_lists(const std::vector<registerInterval*>& intervals);
+    /* \brief records the entry of a new register-interval (the basic block that it starts with)*/
+    void set_entry(registerInterval* interval, basicBlock* entry);
+    basicBlock* entry_block(registerInterval* interval) const;
+    /* \brief the frequency of the entry of a register-interval (0 if not weighted)*/
+    double entry_frequency(registerInterval* interval) const;
+    /* \brief the first key of a candidate in the frontier of pass one: its frequency negated, so the hottest come first (0 if not weighted,
+              so the candidates are in the order of their position)*/
+    double frontier_weight(basicBlock* block) const;
+
+    controlFlowGraph& graph;
+    registerBudget budget;
+    bool weighted;
+    frequencyWeighting weighting;
+    bool loop_admission;
+    bool split_planning;
+    std::vector<basicBlock*> basic_blocks; //set of all basic blocks of application
+    std::vector<registerInterval*> RegisterIntervals; //the set of register-intervals that contains the final register-intervals
+    std::queue<basicBlock*> WS; //The Working Set of register-interval creation algorithm (Pass 1)
+
+    dominatorTree dominators; //The dominator tree of basic blocks (Pass 1)
+    livenessAnalysis liveness; //The live registers of basic blocks (Pass 1)
+    loopForest loops; //The natural loops of basic blocks (Pass 1)
+    blockFrequency frequencies; //The execution frequency of basic blocks (only with frequency weighting)
+    std::vector<basicBlock*> entries; //The entry of each register-interval (by ID)
+    std::vector<registerSet> reaching_registers; //For each basic block of the current register-interval: the registers of the blocks of the interval that reach it without passing the entry of the interval
+    std::vector<int> block_position; //The position of each basic block (by ID) in basic_blocks
+    csrAdjacency dependents; //For each basic block (by ID): the basic blocks that have it as a predecessor
+                             //(the second halves of split basic blocks are not included, they get their own register-intervals)
+
+    epochMarks frontier_marks;  //The candidates that joined the frontier of the current register-interval (by ID, both passes)
+    epochMarks successor_marks; //The successors found for the current register-interval (by ID, both passes)
+    epochMarks member_marks;    //The basic blocks of the current register-interval (by ID, set_exit_live_lists)
+    epochMarks loop_marks;      //The basic blocks (pass one) or the register-intervals (pass two) of the loop that is being admitted (by ID)
+    epochMarks neighbour_marks; //The predecessors or the successors found for a new register-interval (by ID, both passes)
 };
 
 #endif /* INTERVALCREATIONPASS_H */
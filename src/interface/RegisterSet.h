@@ -0,0 +1,75 @@
+/*
+ * \file    RegisterSet.h
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Interface for the register set of basic blocks and register-intervals
+ *          Note: A register set is a fixed-width bit vector (one bit per architectural register),
+ *                so unions and sizes are a few word operations and popcounts.
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#ifndef REGISTERSET_H
+#define REGISTERSET_H
+
+#include <cstdint>
+#include <set>
+#include <string>
+
+#include "Statistics.h"
+
+/* \brief A set of architectural registers (R0 ... R255)*/
+class registerSet
+{
+public:
+	static const int MAX_REGISTERS = 256;
+	static const int WORDS = MAX_REGISTERS / 64;
+
+	registerSet();
+
+        /*
+         * Setters of registerSet class
+         */
+public:
+        /* Add a register (e.g. 12 for R12) to the set; registers out of range are ignored*/
+	void insert(int);
+        /* Add all registers of another set to this set*/
+	void insert(const registerSet&);
+        /* Remove all registers of another set from this set*/
+	void remove(const registerSet&);
+        /* Keep only the registers that are also in another set*/
+	void intersect(const registerSet&);
+        /* Add all register operands ("R" followed by digits) of the instructions in [begin, end) to the set*/
+	void insert_operands(const char* begin, const char* end);
+        /* Remove all registers*/
+	void clear();
+
+        /*
+         * Getters of registerSet class
+         */
+public:
+        /* Get the number of registers in the set*/
+	int size() const;
+        /* Get the number of registers in the union of this set and another set (without constructing the union)*/
+	int union_size(const registerSet&) const;
+        /* Get the number of registers that are in both this set and another set*/
+	int intersection_size(const registerSet&) const;
+        /* Is the register in the set*/
+	bool contains(int) const;
+	bool empty() const;
+	bool operator==(const registerSet&) const;
+	bool operator!=(const registerSet&) const;
+        /* Get the register names of the set (e.g. "R12"), used for logging*/
+	std::set<std::string> names() const;
+        /* Get the set as a hexadecimal bitmask (bit r is register Rr, e.g. "0x1005" for {R0, R2, R12}), used for the structured logs*/
+	std::string bitmask() const;
+
+        /*    Data    */
+private:
+	uint64_t words[WORDS];
+};
+
+#endif /* REGISTERSET_H */
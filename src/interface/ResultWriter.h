@@ -0,0 +1,70 @@
+/*
+ * \file    ResultWriter.h
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Interface for the buffered writer of the output logs
+ *          Note: The logs are collected in a buffer and written in large blocks (nothing is flushed per line),
+ *                so writing the logs of large CFGs costs little compared to the register-interval creation.
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#ifndef RESULTWRITER_H
+#define RESULTWRITER_H
+
+#include <cstdio>
+#include <string>
+
+/* \brief The formats of the output logs*/
+enum logFormat
+{
+	LOG_TEXT,   //the human-readable logs (BasicBlocks_*.txt and registerIntervals_*.txt)
+	LOG_JSONL,  //one JSON object per line (BasicBlocks_*.jsonl and registerIntervals_*.jsonl)
+	LOG_CSV     //a header line and one row per line (BasicBlocks_*.csv and registerIntervals_*.csv)
+};
+
+/* \brief A buffered output file*/
+class resultWriter
+{
+public:
+	resultWriter();
+        /* Open the file at path (the file is not opened if path can not be created; then nothing is written)*/
+	resultWriter(const std::string& path);
+	~resultWriter();
+
+        /* Write the buffer and close the file*/
+	void close();
+        /* Is the file open*/
+	bool is_open() const;
+
+        /*
+         * Writing (to the buffer)
+         */
+public:
+	resultWriter& operator<<(const std::string&);
+	resultWriter& operator<<(const char*);
+	resultWriter& operator<<(char);
+	resultWriter& operator<<(int);
+	resultWriter& operator<<(long long);
+	resultWriter& operator<<(size_t);
+        /* Write a string as a JSON string (quoted and escaped)*/
+	void json_string(const std::string&);
+        /* Write a string as a CSV field (quoted only if it contains a comma, a quote or a line break)*/
+	void csv_field(const std::string&);
+
+        /*    Data    */
+private:
+	resultWriter(const resultWriter&) = delete;
+	resultWriter& operator=(const resultWriter&) = delete;
+
+	void write_buffer();
+
+	static const size_t CAPACITY = 1 << 16;  //the buffer is written when it is larger than this
+	FILE* file;
+	std::string buffer;
+};
+
+#endif /* RESULTWRITER_H */
@@ -0,0 +1,85 @@
+/*
+ * \file    Statistics.h
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Interface for the statistics of a run (--stats): the time of each step, the peak memory of the process and the counters of hot-path events
+ *          Note: The counters are compiled only with -DREGISTER_INTERVAL_STATISTICS (make stats); otherwise COUNT_EVENT is empty
+ *                and the hot paths are exactly as without statistics.
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+/* \brief The hot-path events that are counted*/
+enum statisticsEvent
+{
+	EVENT_ELIGIBILITY_CHECK,    //a candidate basic block (pass one) or register-interval (pass two) is checked
+	EVENT_PREDECESSOR_VISIT,    //a predecessor of a candidate is visited to check that it belongs to the current register-interval
+	EVENT_SPLIT,                //a basic block is split by traverse
+	EVENT_SET_INSERT,           //a register set is added to another one (registerSet::insert)
+	NUMBER_OF_EVENTS
+};
+
+#ifdef REGISTER_INTERVAL_STATISTICS
+#define COUNT_EVENT(event) (runStatistics::counters()[event]++)
+#else
+#define COUNT_EVENT(event) ((void)0)
+#endif
+
+/* \brief The time of one step
+   note: there is no memory per step, the peak resident memory is only known for the whole process (and the steps of kernels overlap in threads)*/
+struct phaseStatistics
+{
+	std::string name;
+	double time;        //ms (the times of the kernels are added)
+};
+
+/* \brief The statistics of a kernel, a file or a run*/
+class runStatistics
+{
+public:
+	runStatistics();
+
+        /* Are the counters compiled*/
+	static bool counting();
+        /* Get the counters of the current thread*/
+	static unsigned long long* counters();
+        /* Set the counters of the current thread to zero*/
+	static void clear_counters();
+        /* Get the peak resident memory of the process (KB)*/
+	static long peak_memory();
+
+        /* Set a function that is called with the name and the time (ms) of each step when it is added (e.g. to keep the times of each repetition)*/
+	void set_step_hook(std::function<void(const std::string&, double)> hook);
+        /* Add time (ms) to the step*/
+	void add_phase(const std::string& name, double time);
+        /* Add the time since begin to the step; begin is set to now*/
+	void end_phase(const std::string& name, std::chrono::steady_clock::time_point& begin);
+        /* Add the counters of the current thread to the counters and set them to zero*/
+	void take_counters();
+        /* Add the steps and counters of another statistics (the steps are kept in the order they run)*/
+	void add(const runStatistics&);
+
+        /* Print a summary table to the standard output*/
+	void print_table() const;
+        /* Write the statistics as JSON; returns false if the file can not be written*/
+	bool write_json(const std::string& path) const;
+
+        /*    Data    */
+private:
+	std::vector<phaseStatistics> phases;
+	unsigned long long events[NUMBER_OF_EVENTS];
+	std::function<void(const std::string&, double)> step_hook;
+};
+
+#endif /* STATISTICS_H */
@@ -0,0 +1,57 @@
+/*
+ * \file    ThreadPool.h
+ *
+ * \authors Ali Hajiabadi <hajiabadi@ce.sharif.edu>
+ *          Mohammad Sadrosadati
+ *          Amirhossein Mirhosseini
+ *
+ * \brief   Interface for the thread pool that runs independent jobs (e.g. one input file per job)
+ *          Note: Jobs are started in the order they are submitted, so submitting the largest jobs first
+ *                keeps all threads busy until the end.
+ *
+ * Note: Register-interval creation algorithm is used in paper "LTRF: Enabling High-Capacity Register Files for GPUs via Hardware/Software Cooperative Register Prefetching" accepted in ASPLOS’18.
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* \brief A fixed number of worker threads that take jobs from a FIFO queue*/
+class threadPool
+{
+public:
+        /* Start the worker threads (0 means one thread per hardware thread)*/
+	threadPool(int threads);
+        /* Wait for all submitted jobs and stop the worker threads*/
+	~threadPool();
+
+        /* Add a job to the end of the queue*/
+	void submit(std::function<void()> job);
+        /* Wait until all submitted jobs are done*/
+	void wait();
+        /* Get the number of worker threads*/
+	int size();
+
+        /*    Data    */
+private:
+	threadPool(const threadPool&) = delete;
+	threadPool& operator=(const threadPool&) = delete;
+
+	void worker();
+
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> jobs;
+	std::mutex lock;
+	std::condition_variable job_available;
+	std::condition_variable all_done;
+	int running;  //the number of jobs that are being run
+	bool stopping;
+};
+
+#endif /* THREADPOOL_H */